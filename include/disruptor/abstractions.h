@@ -45,6 +45,14 @@ public:
     virtual void setSequence(const int64_t& sequence,
             const DependentSequences& dependent_sequences) = 0;
 
+    // Rewind the claimed sequence and forget any cached gating state.
+    //
+    // Only safe when no publisher is claiming and the gating sequences have
+    // been rewound as well.
+    //
+    // @param sequence to be set as the current value.
+    virtual void reset(const int64_t& sequence) = 0;
+
     // Serialise publishing in sequence.
     //
     // @param sequence to be applied.
@@ -60,6 +68,8 @@ private:
 
 typedef stdext::shared_ptr<IClaimStrategy> ClaimStrategyPtr;
 
+class WaitQueue;
+
 // Coordination barrier for tracking the cursor for publishers and sequence of
 // dependent {@link EventProcessor}s for processing a data structure.
 class ISequenceBarrier
@@ -87,11 +97,33 @@ public:
     virtual int64_t waitFor(const int64_t& sequence,
                             const stdext::chrono::microseconds& timeout) = 0;
 
+    // Same as {@link waitFor}, but checking the alert status of another
+    // barrier instead of this one, e.g. an
+    // {@link InterruptibleSequenceBarrier} layered on this one.
+    //
+    // @param sequence to wait for.
+    // @param alerts barrier whose alert status aborts the wait.
+    // @return the sequence up to which is available.
+    //
+    // @throws AlertException if alerts is alerted.
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const ISequenceBarrier& alerts) = 0;
+
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const stdext::chrono::microseconds& timeout,
+                            const ISequenceBarrier& alerts) = 0;
+
     // Delegate a call to the {@link Sequencer#getCursor()}
     //
     //  @return value of the cursor for entries that have been published.
     virtual int64_t getCursor() const = 0;
 
+    // Get the highest sequence available for consumption without waiting,
+    // i.e. the cursor or the minimum of the dependent sequences if any.
+    //
+    // @return the sequence up to which is available.
+    virtual int64_t getAvailableSequence() const = 0;
+
     // The current alert status for the barrier.
     //
     // @return true if in alert otherwise false.
@@ -108,6 +140,12 @@ public:
     //
     // @throws AlertException if barrier is alerted
     virtual void checkAlert() const = 0;
+
+    // Queue on which the {@link IWaitStrategy} parks the threads waiting on
+    // this barrier, if it blocks at all.
+    //
+    // @return the queue, NULL if the barrier has none.
+    virtual WaitQueue* getWaitQueue() const { return NULL; }
 };
 
 typedef stdext::shared_ptr<ISequenceBarrier> SequenceBarrierPtr;
@@ -155,6 +193,18 @@ public:
 
     // Called once on thread stop just before shutdown.
     virtual void onShutdown() = 0;
+
+    // Called when the {@link Disruptor} enters or leaves warm-up. Events seen
+    // while warming_up is set are synthetic and should leave no side effects.
+    virtual void onWarmUp(const bool& warming_up) {}
+
+    // Called on the processor thread when this handler replaces another one
+    // of a running {@link BatchEventProcessor}, between its own onStart and
+    // the onShutdown of the previous handler, to take over its state.
+    //
+    // @param sequence of the last event handled by the previous handler.
+    // @param previous handler being replaced.
+    virtual void onTakeOver(const int64_t& sequence, IEventHandler* previous) {}
 };
 
 // Implementations translate another data representations into events claimed
@@ -269,6 +319,26 @@ public:
     // Signal those waiting that the cursor has advanced.
     virtual void signalAllWhenBlocking() = 0;
 
+    // Signal those waiting that a sequence has advanced, be it the cursor or
+    // the sequence of an {@link EventProcessor} others depend on. Strategies
+    // that do not track who waits on what wake everybody.
+    //
+    // @param sequence that has advanced.
+    virtual void signalWhenBlocking(const Sequence& sequence)
+    {
+        signalAllWhenBlocking();
+    }
+
+    // Have a queue signalled whenever one of the given sequences advances,
+    // until it is removed. Strategies that never block ignore it.
+    //
+    // @param queue of a {@link SequenceBarrier}.
+    // @param sequences the barrier waits on.
+    virtual void addWaitQueue(WaitQueue* queue,
+                              const DependentSequences& sequences) {}
+
+    virtual void removeWaitQueue(WaitQueue* queue) {}
+
 private:
     IWaitStrategy(const IWaitStrategy&);
     IWaitStrategy& operator= (IWaitStrategy);
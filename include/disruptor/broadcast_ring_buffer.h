@@ -0,0 +1,629 @@
+#ifndef DISRUPTOR_BROADCAST_RING_BUFFER_H_
+#define DISRUPTOR_BROADCAST_RING_BUFFER_H_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <disruptor/disruptor.h>
+
+namespace disruptor {
+
+// Unbounded single producer, multiple consumer buffer where every event is
+// seen by every reader, e.g. logging, analytics and replication reading the
+// same stream at their own pace.
+//
+// Events live in a chain of blocks. Each reader has its own cursor and walks
+// the chain on its own; a block is released by the producer once every reader
+// has moved past it, so memory follows the slowest reader. One released block
+// is kept aside and reused by the next allocation, so a steady state stream
+// does not allocate.
+//
+// Readers access events in place, nothing is copied until they ask for it.
+// A reader can also depend on other readers and only see the events they
+// have all committed, which chains readers into a pipeline of stages
+// working on the same events; see {@link DynamicPipeline}.
+//
+// @param <T> event type, must be default constructible and assignable.
+template <typename T>
+class BroadcastDynamicRingBuffer
+{
+public:
+    struct Block : private stdext::noncopyable
+    {
+        // sequence of the first event, set before the block is linked
+        int64_t first_;
+        const size_t size_;
+        stdext::scoped_array<T> events_;
+
+        ALIGN(CACHE_LINE_SIZE_IN_BYTES);
+        stdext::atomic<Block*> next_;
+        char padding_[CACHE_LINE_SIZE_IN_BYTES - sizeof(stdext::atomic<Block*>)];
+
+        Block(size_t size)
+            : first_(0)
+            , size_(size)
+            , events_(new T[size_])
+            , next_(NULL)
+        {
+            assert(size < (size_t)std::numeric_limits<int64_t>::max());
+        }
+
+        int64_t last() const { return first_ + (int64_t)size_ - 1; }
+
+        T* get(const int64_t& sequence)
+        {
+            return &events_[sequence - first_];
+        }
+    };
+
+    // Cursor of one reader of the buffer, to be used by a single thread.
+    class Reader : private stdext::noncopyable
+    {
+    public:
+        // Sequence of the last event read.
+        Sequence* getSequence() { return &sequence_; }
+
+    private:
+        friend class BroadcastDynamicRingBuffer;
+
+        Reader(Block* block,
+               int64_t sequence,
+               const DependentSequences& upstream)
+            : sequence_(sequence)
+            , block_(block)
+            , upstream_(upstream)
+        {
+        }
+
+        Sequence                 sequence_;
+        // block holding sequence_, or the one before the next event
+        Block*                   block_;
+        const DependentSequences upstream_;
+    };
+
+    // @param buffer_size of each block, rounded up to a power of 2.
+    BroadcastDynamicRingBuffer(size_t buffer_size)
+        : buffer_size_(ceilToPow2(buffer_size))
+        , num_blocks_(1)
+        , spare_(NULL)
+    {
+        head_ = tail_ = new Block(buffer_size_);
+    }
+
+    ~BroadcastDynamicRingBuffer()
+    {
+        while (head_ != NULL) {
+            Block* next = head_->next_.load(stdext::memory_order_relaxed);
+            delete head_;
+            head_ = next;
+        }
+        delete spare_;
+        for (size_t i = 0; i < readers_.size(); ++i) {
+            delete readers_[i];
+        }
+    }
+
+    // Add a reader, starting right after the last published event.
+    //
+    // Must be called from the producer thread, readers added before the first
+    // event see the whole stream.
+    //
+    // @param upstream readers whose committed events are the only ones this
+    // reader gets, none to get every published event.
+    // @return reader owned by the buffer.
+    Reader* addReader(const std::vector<Reader*>& upstream = std::vector<Reader*>())
+    {
+        DependentSequences sequences;
+        for (size_t i = 0; i < upstream.size(); ++i) {
+            sequences.push_back(upstream[i]->getSequence());
+        }
+        Reader* reader = new Reader(tail_,
+                                    cursor_.get(stdext::memory_order_relaxed),
+                                    sequences);
+        readers_.push_back(reader);
+        return reader;
+    }
+
+    // Remove a reader, it no longer holds blocks back. Must be called from
+    // the producer thread, once the reader thread has stopped using it and
+    // no other reader depends on it.
+    void removeReader(Reader* reader)
+    {
+        typename std::vector<Reader*>::iterator it =
+            std::find(readers_.begin(), readers_.end(), reader);
+        if (it != readers_.end()) {
+            readers_.erase(it);
+            delete reader;
+        }
+    }
+
+    // Publish an event to every reader.
+    void enqueue(const T& event)
+    {
+        const int64_t sequence = cursor_.get(stdext::memory_order_relaxed) + 1;
+        Block* tail = tail_;
+        if (sequence > tail->last()) {
+            tail = appendBlock(sequence);
+        }
+        *tail->get(sequence) = event;
+        cursor_.set(sequence);
+    }
+
+    // Sequence of the last published event.
+    int64_t getCursor() const
+    {
+        return cursor_.get();
+    }
+
+    // Sequence of the last event a reader may read, the last published one
+    // or the last one committed by all its upstream readers.
+    int64_t getAvailableSequence(const Reader* reader) const
+    {
+        if (reader->upstream_.empty()) {
+            return cursor_.get();
+        }
+        return getMinimumSequence(reader->upstream_);
+    }
+
+    // Get an event for a reader, in place.
+    //
+    // Must be called from the reader thread, for sequences after the last one
+    // committed and up to {@link getAvailableSequence}, in increasing order.
+    //
+    // @param reader reading the event.
+    // @param sequence of the event.
+    T* get(Reader* reader, const int64_t& sequence)
+    {
+        Block* block = reader->block_;
+        while (sequence > block->last()) {
+            block = block->next_.load(stdext::memory_order_acquire);
+        }
+        reader->block_ = block;
+        return block->get(sequence);
+    }
+
+    // Mark the events up to sequence as read, their blocks may be released
+    // right after.
+    void commit(Reader* reader, const int64_t& sequence)
+    {
+        reader->sequence_.set(sequence);
+    }
+
+    // Copy the next event of a reader.
+    //
+    // @return false if the reader has read every published event.
+    bool dequeue(Reader* reader, T& event)
+    {
+        const int64_t sequence = reader->sequence_.get(stdext::memory_order_relaxed) + 1;
+        if (sequence > getAvailableSequence(reader)) {
+            return false;
+        }
+        event = *get(reader, sequence);
+        commit(reader, sequence);
+        return true;
+    }
+
+    size_t occupied_approx(const Reader* reader) const
+    {
+        return cursor_.get(stdext::memory_order_relaxed)
+            - reader->sequence_.get(stdext::memory_order_relaxed);
+    }
+
+    // Blocks allocated, the spare one included. Only accurate on the
+    // producer thread.
+    size_t num_blocks() const
+    {
+        return num_blocks_;
+    }
+
+    size_t num_readers() const
+    {
+        return readers_.size();
+    }
+
+private:
+    Block* appendBlock(int64_t first)
+    {
+        release();
+
+        Block* block = spare_;
+        spare_ = NULL;
+        if (block == NULL) {
+            block = new Block(buffer_size_);
+            ++num_blocks_;
+        }
+        block->first_ = first;
+        block->next_.store(NULL, stdext::memory_order_relaxed);
+
+        tail_->next_.store(block, stdext::memory_order_release);
+        tail_ = block;
+        return block;
+    }
+
+    // Release the blocks every reader has moved past.
+    void release()
+    {
+        int64_t minimum = cursor_.get(stdext::memory_order_relaxed);
+        for (size_t i = 0; i < readers_.size(); ++i) {
+            minimum = std::min(minimum, readers_[i]->sequence_.get());
+        }
+
+        while (head_ != tail_ && head_->last() < minimum) {
+            Block* next = head_->next_.load(stdext::memory_order_relaxed);
+            if (spare_ == NULL) {
+                spare_ = head_;
+            }
+            else {
+                delete head_;
+                --num_blocks_;
+            }
+            head_ = next;
+        }
+    }
+
+    BroadcastDynamicRingBuffer(const BroadcastDynamicRingBuffer&);
+    BroadcastDynamicRingBuffer& operator= (const BroadcastDynamicRingBuffer&);
+
+    Sequence             cursor_;
+    const size_t         buffer_size_;
+    // producer thread only
+    Block*               head_;
+    Block*               tail_;
+    size_t               num_blocks_;
+    Block*               spare_;
+    std::vector<Reader*> readers_;
+};
+
+// Runs an event handler over one reader of a {@link BroadcastDynamicRingBuffer}.
+//
+// The handler gets the events in place, and the reader is committed after
+// every batch.
+template <typename T>
+class BroadcastProcessor : public IEventProcessor<T>
+{
+public:
+    BroadcastProcessor(BroadcastDynamicRingBuffer<T>* ring_buffer,
+                       typename BroadcastDynamicRingBuffer<T>::Reader* reader,
+                       WaitStrategyOption waitStrategy,
+                       IEventHandler<T>* event_handler,
+                       IExceptionHandler<T>* exception_handler,
+                       const stdext::chrono::microseconds& max_idle_time,
+                       const stdext::chrono::microseconds& timer_slack =
+                           stdext::chrono::microseconds(DEFAULT_TIMER_SLACK_US))
+        : running_(false)
+        , ring_buffer_(ring_buffer)
+        , reader_(reader)
+        , event_handler_(event_handler)
+        , exception_handler_(exception_handler)
+        , wait_(max_idle_time)
+        , retries_(MAX_RETRIES_TIMES)
+    {
+        switch (waitStrategy) {
+            case kSleepingStrategy:
+                wait_strategy_ = stdext::bind(&dynamic::sleepFor, wait_, _1);
+                break;
+            case kPreciseSleepingStrategy:
+                wait_strategy_ = stdext::bind(&dynamic::sleepUntilDeadline,
+                                              wait_, timer_slack, _1);
+                break;
+            case kYieldingStrategy:
+            case kBlockingStrategy:
+            case kBusySpinStrategy:
+                // not supported, fall through
+            default:
+                wait_strategy_ = stdext::bind(&dynamic::yieldThis, _1);
+                break;
+        }
+    }
+
+    virtual Sequence* getSequence() { return reader_->getSequence(); }
+
+    virtual void halt()
+    {
+        running_.store(false);
+    }
+
+    void operator() () { run(); }
+
+private:
+    BroadcastProcessor(const BroadcastProcessor&);
+    BroadcastProcessor& operator= (const BroadcastProcessor&);
+
+    void run()
+    {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::runtime_error("Thread is already running");
+        }
+
+        event_handler_->onStart();
+
+        while (running_.load(stdext::memory_order_relaxed)) {
+            const int64_t next_sequence = reader_->getSequence()->get() + 1L;
+            const int64_t available_sequence =
+                ring_buffer_->getAvailableSequence(reader_);
+
+            if (available_sequence < next_sequence) {
+                if (wait_strategy_(retries_)) {
+                    retries_ = MAX_RETRIES_TIMES;
+                    if (wait_.count() != 0) {
+                        // notify handler with NULL event when idle
+                        event_handler_->onEvent(next_sequence, 0, false, NULL);
+                    }
+                }
+                continue;
+            }
+
+            const int64_t batch_size = available_sequence - next_sequence + 1;
+            for (int64_t sequence = next_sequence;
+                    sequence <= available_sequence; ++sequence) {
+                T* event = ring_buffer_->get(reader_, sequence);
+                try {
+                    event_handler_->onEvent(sequence, batch_size,
+                                            sequence == available_sequence,
+                                            event);
+                }
+                catch(const std::exception& e) {
+                    if (exception_handler_) {
+                        exception_handler_->handle(e, sequence, event);
+                    }
+                }
+            }
+            ring_buffer_->commit(reader_, available_sequence);
+            retries_ = MAX_RETRIES_TIMES;
+        }
+
+        event_handler_->onShutdown();
+        running_.store(false);
+    }
+
+    stdext::atomic<bool>                            running_;
+    BroadcastDynamicRingBuffer<T>*                  ring_buffer_;
+    typename BroadcastDynamicRingBuffer<T>::Reader* reader_;
+    dynamic::WaitStrategy                           wait_strategy_;
+    IEventHandler<T>*                               event_handler_;
+    IExceptionHandler<T>*                           exception_handler_;
+    stdext::chrono::microseconds                    wait_;
+    int                                             retries_;
+};
+
+// has similar interface as the DynamicDisruptor, but with the following differences:
+// - every handler sees every event, each on its own thread
+// - handlers read events in place, at their own pace
+// - memory is held back by the slowest handler
+template <typename T>
+class BroadcastDynamicDisruptor
+{
+    public:
+        // will start after construct
+        //
+        // @param size of each block, rounded up to a power of 2.
+        // @param handlers one reader each, in their own thread.
+        BroadcastDynamicDisruptor(size_t size,
+                                  WaitStrategyOption waitStrategy,
+                                  const std::vector<IEventHandler<T>*>& handlers,
+                                  IExceptionHandler<T> * exceptHandler,
+                                  const TimeConfig& timeConfig = TimeConfig())
+            : ring_buffer_(size)
+            , stopped_(false)
+        {
+            const stdext::chrono::microseconds max_idle_time =
+                getTimeConfig(timeConfig, kMaxIdle,
+                              stdext::chrono::microseconds(
+                                  DEFAULT_MAX_IDLE_TIME_US));
+            const stdext::chrono::microseconds timer_slack =
+                getTimeConfig(timeConfig, kTimerSlack,
+                              stdext::chrono::microseconds(
+                                  DEFAULT_TIMER_SLACK_US));
+            for (size_t i = 0; i < handlers.size(); ++i) {
+                processors_.push_back(new BroadcastProcessor<T>(
+                            &ring_buffer_, ring_buffer_.addReader(),
+                            waitStrategy, handlers[i], exceptHandler,
+                            max_idle_time, timer_slack));
+            }
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                consumer_threads_.push_back(new stdext::thread(
+                            stdext::ref< BroadcastProcessor<T> >(*processors_[i])));
+            }
+        }
+
+        virtual ~BroadcastDynamicDisruptor()
+        {
+            if (!stopped_) {
+                this->stop();
+            }
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                delete processors_[i];
+            }
+        }
+
+        void publishEvent(const T& event)
+        {
+            ring_buffer_.enqueue(event);
+        }
+
+        BroadcastProcessor<T>& processor(size_t index)
+        {
+            return *processors_[index];
+        }
+
+        // Events published but not yet handled by the slowest handler.
+        size_t occupiedCapacity() const
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                const int64_t handled = processors_[i]->getSequence()->get();
+                result = std::max(result,
+                                  (size_t)(ring_buffer_.getCursor() - handled));
+            }
+            return result;
+        }
+
+        void stop()
+        {
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                processors_[i]->halt();
+            }
+            for (size_t i = 0; i < consumer_threads_.size(); ++i) {
+                consumer_threads_[i]->join();
+                delete consumer_threads_[i];
+            }
+            consumer_threads_.clear();
+            stopped_ = true;
+        }
+
+    private:
+        BroadcastDynamicRingBuffer<T>        ring_buffer_;
+        std::vector<BroadcastProcessor<T>*>  processors_;
+        std::vector<stdext::thread*>         consumer_threads_;
+        bool                                 stopped_;
+};
+
+// Unbounded pipeline of stages over a single {@link BroadcastDynamicRingBuffer}.
+//
+// Every stage runs its handler on its own thread and sees an event only once
+// all its upstream stages have handled it, so stages can enrich the events in
+// place for the ones downstream instead of copying them into a buffer per
+// hop. Stages without upstream get the events as published. Blocks are
+// released once the last stages have moved past them.
+//
+//   DynamicPipeline<Order> pipeline(1024, kYieldingStrategy, NULL);
+//   size_t decode = pipeline.addStage(&decoder);
+//   size_t risk = pipeline.addStage(&risk_check, std::vector<size_t>(1, decode));
+//   pipeline.then(&journal);
+//   pipeline.start();
+template <typename T>
+class DynamicPipeline
+{
+    public:
+        // @param size of each block, rounded up to a power of 2.
+        DynamicPipeline(size_t size,
+                        WaitStrategyOption waitStrategy,
+                        IExceptionHandler<T> * exceptHandler,
+                        const TimeConfig& timeConfig = TimeConfig())
+            : ring_buffer_(size)
+            , wait_strategy_(waitStrategy)
+            , exception_handler_(exceptHandler)
+            , max_idle_time_(getTimeConfig(timeConfig, kMaxIdle,
+                                           stdext::chrono::microseconds(
+                                               DEFAULT_MAX_IDLE_TIME_US)))
+            , timer_slack_(getTimeConfig(timeConfig, kTimerSlack,
+                                         stdext::chrono::microseconds(
+                                             DEFAULT_TIMER_SLACK_US)))
+            , started_(false)
+        {
+        }
+
+        virtual ~DynamicPipeline()
+        {
+            this->stop();
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                delete processors_[i];
+            }
+        }
+
+        // Add a stage handling every event after its upstream stages.
+        //
+        // @param handler of the stage.
+        // @param upstream indexes of the stages to follow, none to follow the
+        // publisher.
+        // @return index of the new stage.
+        // @throws std::runtime_error once the pipeline is started.
+        // @throws std::invalid_argument for an unknown upstream stage.
+        size_t addStage(IEventHandler<T>* handler,
+                        const std::vector<size_t>& upstream = std::vector<size_t>())
+        {
+            if (started_) {
+                throw std::runtime_error("Pipeline already started");
+            }
+
+            std::vector<typename BroadcastDynamicRingBuffer<T>::Reader*> readers;
+            for (size_t i = 0; i < upstream.size(); ++i) {
+                if (upstream[i] >= readers_.size()) {
+                    throw std::invalid_argument("Unknown upstream stage");
+                }
+                readers.push_back(readers_[upstream[i]]);
+            }
+
+            readers_.push_back(ring_buffer_.addReader(readers));
+            processors_.push_back(new BroadcastProcessor<T>(
+                        &ring_buffer_, readers_.back(), wait_strategy_,
+                        handler, exception_handler_, max_idle_time_,
+                        timer_slack_));
+            return processors_.size() - 1;
+        }
+
+        // Add a stage following the last added one.
+        size_t then(IEventHandler<T>* handler)
+        {
+            if (processors_.empty()) {
+                return addStage(handler);
+            }
+            return addStage(handler,
+                            std::vector<size_t>(1, processors_.size() - 1));
+        }
+
+        // Start one thread per stage, no stage can be added afterwards.
+        void start()
+        {
+            if (started_) {
+                return;
+            }
+            started_ = true;
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                consumer_threads_.push_back(new stdext::thread(
+                            stdext::ref< BroadcastProcessor<T> >(*processors_[i])));
+            }
+        }
+
+        void publishEvent(const T& event)
+        {
+            ring_buffer_.enqueue(event);
+        }
+
+        BroadcastProcessor<T>& stage(size_t index)
+        {
+            return *processors_[index];
+        }
+
+        // Events published but not yet handled by every stage.
+        size_t occupiedCapacity() const
+        {
+            int64_t minimum = ring_buffer_.getCursor();
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                minimum = std::min(minimum,
+                                   processors_[i]->getSequence()->get());
+            }
+            return ring_buffer_.getCursor() - minimum;
+        }
+
+        void stop()
+        {
+            for (size_t i = 0; i < processors_.size(); ++i) {
+                processors_[i]->halt();
+            }
+            for (size_t i = 0; i < consumer_threads_.size(); ++i) {
+                consumer_threads_[i]->join();
+                delete consumer_threads_[i];
+            }
+            consumer_threads_.clear();
+        }
+
+    private:
+        DynamicPipeline(const DynamicPipeline&);
+        DynamicPipeline& operator= (const DynamicPipeline&);
+
+        BroadcastDynamicRingBuffer<T>                               ring_buffer_;
+        const WaitStrategyOption                                    wait_strategy_;
+        IExceptionHandler<T>*                                       exception_handler_;
+        const stdext::chrono::microseconds                          max_idle_time_;
+        const stdext::chrono::microseconds                          timer_slack_;
+        std::vector<typename BroadcastDynamicRingBuffer<T>::Reader*> readers_;
+        std::vector<BroadcastProcessor<T>*>                         processors_;
+        std::vector<stdext::thread*>                                consumer_threads_;
+        bool                                                        started_;
+};
+
+}
+
+#endif
@@ -11,7 +11,8 @@ const int DEFAULT_RETRY_TIMES = 1000;
 enum ClaimStrategyOption {
     kSingleThreadedStrategy,
     kMultiThreadedStrategy,
-    kMultiThreadedLowContentionStrategy
+    kMultiThreadedLowContentionStrategy,
+    kMultiThreadedFairStrategy
 };
 
 // Optimised strategy can be used when there is a single publisher thread
@@ -19,7 +20,7 @@ enum ClaimStrategyOption {
 class SingleThreadedStrategy : public IClaimStrategy
 {
 public:
-    SingleThreadedStrategy(const int& buffer_size)
+    SingleThreadedStrategy(const int64_t& buffer_size)
         : buffer_size_(buffer_size)
         , sequence_(INITIAL_CURSOR_VALUE)
         , min_gating_sequence_(INITIAL_CURSOR_VALUE)
@@ -62,6 +63,12 @@ public:
         waitForFreeSlotAt(sequence, dependent_sequences);
     }
 
+    virtual void reset(const int64_t& sequence)
+    {
+        sequence_.set(sequence);
+        min_gating_sequence_.set(sequence);
+    }
+
     virtual void serialisePublishing(const int64_t& sequence,
             Sequence& cursor,
             const int64_t& batch_size)
@@ -86,7 +93,7 @@ private:
         }
     }
 
-    const int   buffer_size_;
+    const int64_t buffer_size_;
     PaddedLong  sequence_;
     PaddedLong  min_gating_sequence_;
 };
@@ -96,7 +103,7 @@ private:
 class MultiThreadedLowContentionStrategy : public IClaimStrategy
 {
 public:
-    MultiThreadedLowContentionStrategy(const int& buffer_size)
+    MultiThreadedLowContentionStrategy(const int64_t& buffer_size)
         : buffer_size_(buffer_size)
         , sequence_(INITIAL_CURSOR_VALUE)
         , min_gating_sequence_(INITIAL_CURSOR_VALUE)
@@ -127,6 +134,12 @@ public:
         waitForFreeSlotAt(sequence, dependent_sequences);
     }
 
+    virtual void reset(const int64_t& sequence)
+    {
+        sequence_.set(sequence);
+        min_gating_sequence_.set(sequence);
+    }
+
     virtual bool hasAvailableCapacity(
             const DependentSequences& dependent_sequences)
     {
@@ -162,18 +175,18 @@ protected:
             int64_t min_sequence;
             while (wrap_point >
                     (min_sequence = getMinimumSequence(dependent_sequences))) {
-                if (counter > 0) {
-                    counter--;
-                }
-                else {
-                    stdext::this_thread::sleep(stdext::chrono::milliseconds(1));
-                }
+                counter = applyBackPressure(counter);
             }
             min_gating_sequence_.set(min_sequence);
         }
     }
 
-    int applyBackPressure(int counter) 
+    // Back-off of a publisher waiting for a free slot or for its turn to
+    // publish: spin while the counter lasts, then sleep.
+    //
+    // @param counter spins left.
+    // @return spins left after this one.
+    virtual int applyBackPressure(int counter)
     {
         if (counter > 0) {
             --counter;
@@ -185,7 +198,7 @@ protected:
         return counter;
     }
 
-    const int   buffer_size_;
+    const int64_t buffer_size_;
     Sequence    sequence_;
     MutableLong min_gating_sequence_; // not atomic, but is safe enough for wrap checking
     const int   retries_;
@@ -195,7 +208,7 @@ protected:
 class MultiThreadedStrategy : public MultiThreadedLowContentionStrategy
 {
 public:
-    MultiThreadedStrategy(const int& buffer_size)
+    MultiThreadedStrategy(const int64_t& buffer_size)
         : MultiThreadedLowContentionStrategy(buffer_size)
         , pending_size_(0)
         , pending_mask_(0)
@@ -208,13 +221,22 @@ public:
      * @param buffer_size for the underlying data structure.
      * @param pending_buffer_size number of item that can be pending for serialisation
      */
-    MultiThreadedStrategy(const int& buffer_size,
+    MultiThreadedStrategy(const int64_t& buffer_size,
             int pending_buffer_size = DEFAULT_PENDING_BUFFER_SIZE)
         : MultiThreadedLowContentionStrategy(buffer_size)
         , pending_size_(ceilToPow2(pending_buffer_size))
-        , pending_publication_(new Sequence[pending_buffer_size])
-        , pending_mask_(pending_buffer_size - 1)
+        , pending_publication_(new Sequence[pending_size_])
+        , pending_mask_(pending_size_ - 1)
+    {
+    }
+
+    virtual void reset(const int64_t& sequence)
     {
+        MultiThreadedLowContentionStrategy::reset(sequence);
+        // stale entries would otherwise be mistaken for pending publications
+        for (int64_t i = 0; i <= pending_mask_; ++i) {
+            pending_publication_[i].set(INITIAL_CURSOR_VALUE);
+        }
     }
 
     virtual void serialisePublishing(const int64_t& sequence,
@@ -263,8 +285,56 @@ private:
 };
 
 
+// Strategy for multiple publisher threads that must all see a bounded
+// publish latency, whatever their placement and however many they are.
+//
+// Fairness comes from the ticket ordering of {@link
+// MultiThreadedLowContentionStrategy}: claims are tickets taken in order,
+// slots are freed in sequence order, and the cursor is handed over strictly
+// in ticket order, so no publisher can be overtaken or lose a race
+// repeatedly. Only the back-off differs: waiting publishers spin briefly then
+// yield instead of sleeping, which keeps the holder of the previous ticket
+// running when there are more publishers than cores. Throughput is a little
+// lower than {@link MultiThreadedStrategy} under heavy contention, the tail
+// latency of each publisher is much lower.
+class FairMultiThreadedStrategy : public MultiThreadedLowContentionStrategy
+{
+public:
+    FairMultiThreadedStrategy(const int64_t& buffer_size)
+        : MultiThreadedLowContentionStrategy(buffer_size)
+    {
+    }
+
+    virtual void serialisePublishing(const int64_t& sequence,
+                                     Sequence& cursor,
+                                     const int64_t& batch_size)
+    {
+        const int64_t expected_sequence = sequence - batch_size;
+        int counter = retries_;
+        while (expected_sequence != cursor.get()) {
+            counter = applyBackPressure(counter);
+        }
+
+        cursor.set(sequence);
+    }
+
+protected:
+    virtual int applyBackPressure(int counter)
+    {
+        if (counter > 0) {
+            --counter;
+        }
+        else {
+            stdext::this_thread::yield();
+        }
+
+        return counter;
+    }
+};
+
+
 inline ClaimStrategyPtr createClaimStrategy(ClaimStrategyOption option,
-                                            const int& buffer_size)
+                                            const int64_t& buffer_size)
 {
     switch (option) {
         case kSingleThreadedStrategy:
@@ -277,6 +347,9 @@ inline ClaimStrategyPtr createClaimStrategy(ClaimStrategyOption option,
          case kMultiThreadedLowContentionStrategy:
             return stdext::make_shared<MultiThreadedLowContentionStrategy>(
                     buffer_size);
+         case kMultiThreadedFairStrategy:
+            return stdext::make_shared<FairMultiThreadedStrategy>(
+                    buffer_size);
         default:
             return ClaimStrategyPtr();
     }
@@ -0,0 +1,321 @@
+#ifndef DISRUPTOR_COOPERATIVE_EXECUTOR_H_
+#define DISRUPTOR_COOPERATIVE_EXECUTOR_H_
+
+#include <deque>
+
+#include <disruptor/ring_buffer.h>
+
+namespace disruptor {
+
+const int64_t DEFAULT_EXECUTOR_BATCH_SIZE = 64;
+const int DEFAULT_EXECUTOR_IDLE_POLLS = 100;
+
+// Unit of work run by a {@link CooperativeExecutor}. Unlike an
+// {@link EventProcessor} it does not own a thread and must never block.
+class IPollable
+{
+public:
+    virtual ~IPollable() {};
+
+    // Called once from an executor thread before the first poll.
+    virtual void onStart() = 0;
+
+    // Process up to max_batch available events without waiting.
+    //
+    // @param max_batch upper bound of events to process in this call.
+    // @return number of events processed, 0 if nothing was available.
+    virtual int64_t poll(const int64_t& max_batch) = 0;
+
+    // Called once when the executor stops, after its threads are joined.
+    virtual void onShutdown() = 0;
+};
+
+// Event processor to be polled by a {@link CooperativeExecutor}, it runs the
+// same batch loop as {@link BatchEventProcessor} but returns to the executor
+// instead of waiting once the barrier runs dry or max_batch is reached.
+//
+// @param <T> event type stored in the {@link RingBuffer}.
+template <typename T>
+class CooperativeEventProcessor : public IEventProcessor<T>
+                                , public IPollable
+{
+public:
+    CooperativeEventProcessor(RingBuffer<T>* ring_buffer,
+                              SequenceBarrierPtr sequence_barrier,
+                              IEventHandler<T>* event_handler,
+                              IExceptionHandler<T>* exception_handler)
+        : ring_buffer_(ring_buffer)
+        , sequence_barrier_(sequence_barrier)
+        , event_handler_(event_handler)
+        , exception_handler_(exception_handler)
+    {
+    }
+
+    virtual Sequence* getSequence() { return &sequence_; }
+
+    // Stop consuming, the task stays registered and polls as empty.
+    virtual void halt() { sequence_barrier_->alert(); }
+
+    virtual void onStart() { event_handler_->onStart(); }
+
+    virtual int64_t poll(const int64_t& max_batch)
+    {
+        if (sequence_barrier_->isAlerted()) {
+            return 0;
+        }
+
+        int64_t next_sequence = sequence_.get(stdext::memory_order_relaxed) + 1L;
+        int64_t available_sequence = sequence_barrier_->getAvailableSequence();
+        if (available_sequence < next_sequence) {
+            return 0;
+        }
+
+        available_sequence = std::min(available_sequence,
+                                      next_sequence + max_batch - 1);
+        const int64_t batch_size = available_sequence - next_sequence + 1;
+
+        T* event = NULL;
+        while (next_sequence <= available_sequence) {
+            try {
+                event = ring_buffer_->get(next_sequence);
+                event_handler_->onEvent(next_sequence,
+                        batch_size,
+                        next_sequence == available_sequence, event);
+            }
+            catch(const std::exception& e) {
+                if (exception_handler_) {
+                    exception_handler_->handle(e, next_sequence, event);
+                }
+            }
+            next_sequence++;
+        }
+
+        sequence_.set(available_sequence);
+        ring_buffer_->signal(sequence_);
+        return batch_size;
+    }
+
+    virtual void onShutdown() { event_handler_->onShutdown(); }
+
+private:
+    CooperativeEventProcessor(const CooperativeEventProcessor& c);
+    CooperativeEventProcessor& operator= (CooperativeEventProcessor c);
+
+    Sequence                     sequence_;
+    RingBuffer<T>*               ring_buffer_;
+    SequenceBarrierPtr           sequence_barrier_;
+    IEventHandler<T>*            event_handler_;
+    IExceptionHandler<T>*        exception_handler_;
+};
+
+// Runs many {@link IPollable}s on a small, fixed pool of threads.
+//
+// Runnable tasks sit in a single FIFO run queue and each turn is bounded by
+// max_batch events, so a busy ring can't starve the others. A task that stays
+// dry for idle_polls turns in a row is parked: it leaves the run queue and
+// costs nothing until a publisher calls {@link #notify} for it.
+//
+// Publishers must call notify after publishing, a notify racing with a task
+// being parked is never lost.
+class CooperativeExecutor
+{
+public:
+    class Task : private stdext::noncopyable
+    {
+    public:
+        explicit Task(IPollable* pollable)
+            : pollable_(pollable)
+            , state_(kParked)
+            , idle_polls_(0)
+            , started_(false)
+        {
+        }
+
+    private:
+        friend class CooperativeExecutor;
+
+        enum State {
+            kParked,
+            kQueued,
+            kRunning,
+            // notified while running, must be polled once more
+            kNotified
+        };
+
+        IPollable*          pollable_;
+        stdext::atomic<int> state_;
+        int                 idle_polls_;
+        bool                started_;
+    };
+
+    // @param num_threads of the pool.
+    // @param max_batch events processed per turn of a task.
+    // @param idle_polls dry turns before a task gets parked.
+    CooperativeExecutor(int num_threads,
+                        int64_t max_batch = DEFAULT_EXECUTOR_BATCH_SIZE,
+                        int idle_polls = DEFAULT_EXECUTOR_IDLE_POLLS)
+        : num_threads_(num_threads)
+        , max_batch_(max_batch)
+        , idle_polls_(idle_polls)
+        , running_(false)
+    {
+    }
+
+    ~CooperativeExecutor()
+    {
+        stop();
+        for (size_t i = 0; i < tasks_.size(); ++i) {
+            delete tasks_[i];
+        }
+    }
+
+    // Register a pollable, it starts out runnable.
+    //
+    // @param pollable to run, must outlive the executor.
+    // @return handle to pass to {@link #notify}.
+    Task* add(IPollable* pollable)
+    {
+        Task* task = new Task(pollable);
+        {
+            stdext::unique_lock<stdext::mutex> ulock(mutex_);
+            tasks_.push_back(task);
+        }
+        notify(task);
+        return task;
+    }
+
+    // Make a task runnable again, called by publishers after publishing.
+    //
+    // @param task returned by {@link #add}.
+    void notify(Task* task)
+    {
+        // orders the publish before the load of the state, pairs with the
+        // fence in run(): either the task is seen running, or its poll sees
+        // the published events
+        stdext::atomic_thread_fence(stdext::memory_order_seq_cst);
+        int state = task->state_.load();
+        while (true) {
+            if (state == Task::kParked) {
+                if (task->state_.compare_exchange_weak(state, Task::kQueued)) {
+                    enqueue(task);
+                    return;
+                }
+            }
+            else if (state == Task::kRunning) {
+                if (task->state_.compare_exchange_weak(state, Task::kNotified)) {
+                    return;
+                }
+            }
+            else {
+                // already queued or notified
+                return;
+            }
+        }
+    }
+
+    void start()
+    {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::runtime_error("Executor is already running");
+        }
+
+        for (int i = 0; i < num_threads_; ++i) {
+            threads_.push_back(stdext::make_shared<stdext::thread>(
+                        stdext::bind(&CooperativeExecutor::run, this)));
+        }
+    }
+
+    // Join the pool and call onShutdown on every task that was started.
+    void stop()
+    {
+        bool expected = true;
+        if (!running_.compare_exchange_strong(expected, false)) {
+            return;
+        }
+
+        {
+            stdext::unique_lock<stdext::mutex> ulock(mutex_);
+            not_empty_.notify_all();
+        }
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            threads_[i]->join();
+        }
+        threads_.clear();
+
+        for (size_t i = 0; i < tasks_.size(); ++i) {
+            if (tasks_[i]->started_) {
+                tasks_[i]->pollable_->onShutdown();
+                tasks_[i]->started_ = false;
+            }
+        }
+    }
+
+private:
+    void enqueue(Task* task)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        run_queue_.push_back(task);
+        not_empty_.notify_one();
+    }
+
+    Task* dequeue()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        while (running_.load() && run_queue_.empty()) {
+            not_empty_.wait(ulock);
+        }
+        if (!running_.load()) {
+            // leave queued tasks for the next start
+            return NULL;
+        }
+
+        Task* task = run_queue_.front();
+        run_queue_.pop_front();
+        return task;
+    }
+
+    void run()
+    {
+        Task* task;
+        while ((task = dequeue()) != NULL) {
+            task->state_.store(Task::kRunning);
+            // orders the store of the state before the poll reads the cursor
+            stdext::atomic_thread_fence(stdext::memory_order_seq_cst);
+            if (!task->started_) {
+                task->pollable_->onStart();
+                task->started_ = true;
+            }
+
+            if (task->pollable_->poll(max_batch_) > 0) {
+                task->idle_polls_ = 0;
+            }
+            else if (++task->idle_polls_ >= idle_polls_) {
+                int expected = Task::kRunning;
+                if (task->state_.compare_exchange_strong(expected, Task::kParked)) {
+                    task->idle_polls_ = 0;
+                    continue;
+                }
+                // notified while polling, go round once more
+            }
+
+            task->state_.store(Task::kQueued);
+            enqueue(task);
+        }
+    }
+
+    const int                   num_threads_;
+    const int64_t               max_batch_;
+    const int                   idle_polls_;
+    stdext::atomic<bool>        running_;
+
+    stdext::mutex               mutex_;
+    stdext::condition_variable  not_empty_;
+    std::deque<Task*>           run_queue_;
+    std::vector<Task*>          tasks_;
+    std::vector< stdext::shared_ptr<stdext::thread> > threads_;
+};
+
+}
+
+#endif
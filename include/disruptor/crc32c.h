@@ -0,0 +1,112 @@
+#ifndef DISRUPTOR_CRC32C_H_
+#define DISRUPTOR_CRC32C_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define DISRUPTOR_HAS_SSE42_CRC32C
+#endif
+
+namespace disruptor {
+
+// Castagnoli polynomial, reflected.
+const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+namespace detail {
+
+class Crc32cTable
+{
+public:
+    Crc32cTable()
+    {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0U - (crc & 1U)));
+            }
+            table_[i] = crc;
+        }
+    }
+
+    uint32_t operator[] (size_t i) const { return table_[i]; }
+
+private:
+    uint32_t table_[256];
+};
+
+inline uint32_t crc32cSoftware(uint32_t crc, const unsigned char* data,
+                               size_t length)
+{
+    static const Crc32cTable table;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef DISRUPTOR_HAS_SSE42_CRC32C
+__attribute__((target("sse4.2")))
+inline uint32_t crc32cHardware(uint32_t crc, const unsigned char* data,
+                               size_t length)
+{
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    for ( ; length >= sizeof(uint64_t); length -= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += sizeof(word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    for ( ; length >= sizeof(uint32_t); length -= sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        data += sizeof(word);
+    }
+    for ( ; length > 0; --length) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+}
+
+// Whether crc32c runs on the SSE4.2 crc32 instruction on this host.
+inline bool hasHardwareCrc32c()
+{
+#ifdef DISRUPTOR_HAS_SSE42_CRC32C
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// CRC32C (Castagnoli) of a buffer, as used by iSCSI, ext4 and most journals.
+// Uses the SSE4.2 crc32 instruction when the CPU has it, a table otherwise.
+//
+// @param data to checksum.
+// @param length of data in bytes.
+// @param crc of the preceding data when checksumming in pieces, 0 otherwise.
+// @return checksum of the data.
+inline uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+#ifdef DISRUPTOR_HAS_SSE42_CRC32C
+    if (hasHardwareCrc32c()) {
+        return ~detail::crc32cHardware(~crc, bytes, length);
+    }
+#endif
+    return ~detail::crc32cSoftware(~crc, bytes, length);
+}
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef DISRUPTOR_DELTA_CODEC_H_
+#define DISRUPTOR_DELTA_CODEC_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include <disruptor/utils.h>
+
+#ifdef has_cplusplus11
+#include <type_traits>
+#endif
+
+namespace disruptor {
+
+// Columnar delta + varint encoding of a batch of fixed-layout events, meant
+// for journaling events whose fields (sequence, timestamp, price...) move by
+// small steps from one event to the next.
+//
+// An event is seen as sizeof(T) / 8 little endian 64-bit words plus a few
+// tail bytes. Each word is a column: it is stored as the zigzag varint of its
+// difference with the same word of the previous event, column after column so
+// the decoder runs one tight loop per column. Tail bytes are copied as is.
+//
+// Batch layout: varint event count, then every column, then every tail.
+// Batches are self-contained, the first event is encoded against zeros.
+//
+// @param <T> trivially copyable event type.
+template <typename T>
+class DeltaCodec
+{
+#ifdef has_cplusplus11
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "DeltaCodec needs a trivially copyable event type");
+#endif
+
+public:
+    static const size_t kColumns = sizeof(T) / sizeof(uint64_t);
+    static const size_t kTailBytes = sizeof(T) % sizeof(uint64_t);
+
+    // Encode a batch and append it to out.
+    //
+    // @param events to encode.
+    // @param count of events.
+    // @param out receives the encoded batch.
+    static void encode(const T* events, size_t count,
+                       std::vector<unsigned char>& out)
+    {
+        // worst case is 10 bytes per word
+        out.reserve(out.size() + 10 + count * (kColumns * 10 + kTailBytes));
+        putVarint(out, count);
+
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(events);
+        for (size_t column = 0; column < kColumns; ++column) {
+            uint64_t previous = 0;
+            const unsigned char* word = bytes + column * sizeof(uint64_t);
+            for (size_t i = 0; i < count; ++i, word += sizeof(T)) {
+                uint64_t value;
+                memcpy(&value, word, sizeof(value));
+                int64_t delta = static_cast<int64_t>(value - previous);
+                putVarint(out, (static_cast<uint64_t>(delta) << 1)
+                               ^ static_cast<uint64_t>(delta >> 63));
+                previous = value;
+            }
+        }
+
+        const unsigned char* tail = bytes + kColumns * sizeof(uint64_t);
+        for (size_t i = 0; i < count && kTailBytes > 0; ++i, tail += sizeof(T)) {
+            out.insert(out.end(), tail, tail + kTailBytes);
+        }
+    }
+
+    // Decode one batch and append its events to events.
+    //
+    // @param data holding the encoded batch.
+    // @param length of data in bytes.
+    // @param events receives the decoded events.
+    // @return number of bytes consumed, 0 if data is truncated or malformed.
+    static size_t decode(const unsigned char* data, size_t length,
+                         std::vector<T>& events)
+    {
+        const unsigned char* position = data;
+        const unsigned char* end = data + length;
+
+        uint64_t count;
+        if (!getVarint(position, end, count)
+                || count > length) {
+            return 0;
+        }
+
+        const size_t first = events.size();
+        events.resize(first + count);
+        unsigned char* bytes = reinterpret_cast<unsigned char*>(&events[first]);
+
+        for (size_t column = 0; column < kColumns; ++column) {
+            uint64_t value = 0;
+            unsigned char* word = bytes + column * sizeof(uint64_t);
+            for (size_t i = 0; i < count; ++i, word += sizeof(T)) {
+                // eight one byte deltas in a row, checked with a single load
+                uint64_t run;
+                if (count - i >= 8 && end - position >= 8
+                        && (memcpy(&run, position, sizeof(run)),
+                            (run & 0x8080808080808080ULL) == 0)) {
+                    for (int j = 0; j < 8; ++j, word += sizeof(T)) {
+                        const uint64_t zigzag = position[j];
+                        value += (zigzag >> 1) ^ (0 - (zigzag & 1));
+                        memcpy(word, &value, sizeof(value));
+                    }
+                    position += 8;
+                    i += 7;
+                    word -= sizeof(T);
+                    continue;
+                }
+
+                uint64_t zigzag;
+                if (!getVarint(position, end, zigzag)) {
+                    events.resize(first);
+                    return 0;
+                }
+                value += (zigzag >> 1) ^ (0 - (zigzag & 1));
+                memcpy(word, &value, sizeof(value));
+            }
+        }
+
+        if (static_cast<size_t>(end - position) < count * kTailBytes) {
+            events.resize(first);
+            return 0;
+        }
+        unsigned char* tail = bytes + kColumns * sizeof(uint64_t);
+        for (size_t i = 0; i < count && kTailBytes > 0; ++i, tail += sizeof(T)) {
+            memcpy(tail, position, kTailBytes);
+            position += kTailBytes;
+        }
+
+        return position - data;
+    }
+
+private:
+    static void putVarint(std::vector<unsigned char>& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+
+    static bool getVarint(const unsigned char*& position,
+                          const unsigned char* end,
+                          uint64_t& value)
+    {
+        // most deltas fit in a byte
+        if (position < end && *position < 0x80) {
+            value = *position++;
+            return true;
+        }
+
+        value = 0;
+        for (int shift = 0; shift < 64 && position < end; shift += 7) {
+            const unsigned char byte = *position++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (byte < 0x80) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
+
+#endif
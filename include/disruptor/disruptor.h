@@ -19,7 +19,7 @@ class Disruptor
 {
     public:
         // will start after construct
-        Disruptor(int size,
+        Disruptor(int64_t size,
                   ClaimStrategyOption claimStrategy,
                   WaitStrategyOption waitStrategy,
                   IEventHandler<T> * handler,
@@ -34,6 +34,7 @@ class Disruptor
             , publisher_(&ring_buffer_)
             , consumer_thread_(stdext::ref< BatchEventProcessor<T> >(processor_))
             , stopped_(false)
+            , handler_(handler)
         {
             ring_buffer_.setGatingSequences(
                     DependentSequences(1, processor_.getSequence())
@@ -52,11 +53,24 @@ class Disruptor
             publisher_.publishEvent(translator);
         }
 
+        // See {@link EventPublisher#publishEvent}, one histogram per thread.
+        void publishEvent(IEventTranslator<T>* translator,
+                          LatencyHistogram* latency)
+        {
+            publisher_.publishEvent(translator, latency);
+        }
+
         bool tryPublishEvent(IEventTranslator<T>* translator)
         {
             return publisher_.tryPublishEvent(translator);
         }
 
+        // See {@link EventPublisher#setWritePrefetchDistance}.
+        void setWritePrefetchDistance(const int64_t& distance)
+        {
+            publisher_.setWritePrefetchDistance(distance);
+        }
+
         bool full() const
         {
             return !publisher_.hasAvailableCapacity();
@@ -67,6 +81,12 @@ class Disruptor
             return processor_;
         }
 
+        // See {@link Sequencer#getWaitStrategy}.
+        IWaitStrategy* getWaitStrategy() const
+        {
+            return ring_buffer_.getWaitStrategy();
+        }
+
         void stop()
         {
             processor_.halt();
@@ -74,18 +94,93 @@ class Disruptor
             stopped_ = true;
         }
 
-        int occupiedCapacity() const
+        // Park the consumer thread, see {@link BatchEventProcessor#pause}.
+        void pause()
+        {
+            processor_.pause();
+        }
+
+        void resume()
+        {
+            processor_.resume();
+        }
+
+        // Replace the handler of the running consumer, see
+        // {@link BatchEventProcessor#swapHandler}.
+        void swapHandler(IEventHandler<T>* handler)
+        {
+            processor_.swapHandler(handler);
+            handler_ = handler;
+        }
+
+        int64_t occupiedCapacity() const
         {
             return ring_buffer_.occupiedCapacity();
         }
 
+        // Get the ring memory and the consumer hot path warm before going
+        // live: pre-fault (and optionally lock) the events, push synthetic
+        // events through the processor, then rewind every sequence so the
+        // first real event is published at sequence 0 again.
+        //
+        // Must be called before anything is published, from the only
+        // publishing thread. The processor thread is restarted twice, so the
+        // handler sees onStart/onShutdown around each phase, and
+        // onWarmUp(true/false) while the processor is parked in between.
+        //
+        // @param translator fills the synthetic events.
+        // @param iterations number of synthetic events to publish.
+        // @param lock_memory also mlock the events.
+        // @return false if locking was requested and failed.
+        bool warmUp(IEventTranslator<T>* translator,
+                    int64_t iterations,
+                    bool lock_memory = false)
+        {
+            bool result = ring_buffer_.preFault(lock_memory);
+
+            haltConsumer();
+            handler_->onWarmUp(true);
+            startConsumer();
+
+            for (int64_t i = 0; i < iterations; ++i) {
+                publisher_.publishEvent(translator);
+            }
+            const int64_t last_sequence = ring_buffer_.getCursor();
+            while (processor_.getSequence()->get() < last_sequence) {
+                stdext::this_thread::yield();
+            }
+
+            haltConsumer();
+            handler_->onWarmUp(false);
+            ring_buffer_.reset();
+            processor_.getSequence()->set(INITIAL_CURSOR_VALUE);
+            startConsumer();
+
+            return result;
+        }
+
     private:
+        void haltConsumer()
+        {
+            processor_.halt();
+            consumer_thread_.join();
+        }
+
+        void startConsumer()
+        {
+            barrier_->clearAlert();
+            stdext::thread consumer_thread(
+                    stdext::ref< BatchEventProcessor<T> >(processor_));
+            consumer_thread_.swap(consumer_thread);
+        }
+
         RingBuffer<T>           ring_buffer_;
         SequenceBarrierPtr      barrier_;
         BatchEventProcessor<T>  processor_;
         EventPublisher<T>       publisher_;
         stdext::thread           consumer_thread_;
         bool                    stopped_;
+        IEventHandler<T>*       handler_;
 };
 
 
@@ -99,19 +194,28 @@ class DynamicDisruptor
 {
     public:
         // will start after construct
+        //
+        // @param max_size blocks grow up to this size, see
+        // {@link DynamicRingBuffer}, 0 to keep them all at size.
         DynamicDisruptor(size_t size,
                   ClaimStrategyOption claimStrategy, // not useful here
                   WaitStrategyOption waitStrategy,
                   IEventHandler<T> * handler,
                   IExceptionHandler<T> * exceptHandler,
-                  const TimeConfig& timeConfig = TimeConfig())
-            : ring_buffer_(size, claimStrategy, waitStrategy, timeConfig)
+                  const TimeConfig& timeConfig = TimeConfig(),
+                  size_t max_size = 0)
+            : ring_buffer_(size, claimStrategy, waitStrategy, timeConfig,
+                           max_size)
             , processor_(&ring_buffer_, waitStrategy, handler, exceptHandler,
                          getTimeConfig(timeConfig, kMaxIdle,
                                        stdext::chrono::microseconds(
-                                           DEFAULT_MAX_IDLE_TIME_US)))
+                                           DEFAULT_MAX_IDLE_TIME_US)),
+                         getTimeConfig(timeConfig, kTimerSlack,
+                                       stdext::chrono::microseconds(
+                                           DEFAULT_TIMER_SLACK_US)))
             , consumer_thread_(stdext::ref< DynamicProcessor<T> >(processor_))
             , stopped_(false)
+            , handler_(handler)
         {
         }
 
@@ -127,6 +231,14 @@ class DynamicDisruptor
             ring_buffer_.enqueue(event);
         }
 
+        // Publish a range of events, see {@link DynamicRingBuffer#enqueue_bulk}.
+        // The range is walked twice, so it takes forward iterators.
+        template <typename ForwardIterator>
+        void publishEvents(ForwardIterator first, ForwardIterator last)
+        {
+            ring_buffer_.enqueue_bulk(first, last);
+        }
+
         bool full() const
         {
             return !ring_buffer_.has_available_capacity();
@@ -149,11 +261,60 @@ class DynamicDisruptor
             return ring_buffer_.occupied_approx();
         }
 
+        // Same as {@link Disruptor#warmUp}, additionally allocates the blocks
+        // needed to hold capacity events before pre-faulting them.
+        //
+        // @param event copied as every synthetic event.
+        // @param iterations number of synthetic events to publish.
+        // @param capacity the buffer should hold without allocating.
+        // @param lock_memory also mlock the events.
+        // @return false if locking was requested and failed.
+        bool warmUp(const T& event,
+                    int64_t iterations,
+                    size_t capacity = 0,
+                    bool lock_memory = false)
+        {
+            ring_buffer_.reserve(capacity);
+            bool result = ring_buffer_.preFault(lock_memory);
+
+            haltConsumer();
+            handler_->onWarmUp(true);
+            startConsumer();
+
+            for (int64_t i = 0; i < iterations; ++i) {
+                ring_buffer_.enqueue(event);
+            }
+            while (ring_buffer_.occupied_approx() != 0) {
+                stdext::this_thread::yield();
+            }
+
+            haltConsumer();
+            handler_->onWarmUp(false);
+            processor_.getSequence()->set(INITIAL_CURSOR_VALUE);
+            startConsumer();
+
+            return result;
+        }
+
     private:
+        void haltConsumer()
+        {
+            processor_.halt();
+            consumer_thread_.join();
+        }
+
+        void startConsumer()
+        {
+            stdext::thread consumer_thread(
+                    stdext::ref< DynamicProcessor<T> >(processor_));
+            consumer_thread_.swap(consumer_thread);
+        }
+
         DynamicRingBuffer<T>    ring_buffer_;
         DynamicProcessor<T>     processor_;
         stdext::thread          consumer_thread_;
         bool                    stopped_;
+        IEventHandler<T>*       handler_;
 };
 
 }
@@ -24,6 +24,23 @@ inline bool sleepFor(const stdext::chrono::microseconds& max_idle, int& retries)
     }
 }
 
+// Sleep to an absolute deadline, with the timer slack of the thread lowered
+// as {@link PreciseSleepingStrategy} does.
+inline bool sleepUntilDeadline(const stdext::chrono::microseconds& max_idle,
+                               const stdext::chrono::microseconds& timer_slack,
+                               int& retries)
+{
+    if (retries <= 0) {
+        setTimerSlack(std::max<int64_t>(timer_slack.count() * 1000, 1));
+        sleepUntil(monotonicNanos() + (int64_t)max_idle.count() * 1000);
+        return true;
+    }
+    else {
+        --retries;
+        return false;
+    }
+}
+
 inline bool yieldThis(int& retries)
 {
     if (retries <= 0) {
@@ -46,7 +63,9 @@ public:
                      WaitStrategyOption waitStrategy,
                      IEventHandler<T>* event_handler,
                      IExceptionHandler<T>* exception_handler,
-                     const stdext::chrono::microseconds& max_idle_time)
+                     const stdext::chrono::microseconds& max_idle_time,
+                     const stdext::chrono::microseconds& timer_slack =
+                         stdext::chrono::microseconds(DEFAULT_TIMER_SLACK_US))
         : running_(false)
         , ring_buffer_(ring_buffer)
         , event_handler_(event_handler)
@@ -59,6 +78,10 @@ public:
             case kSleepingStrategy:
                 wait_strategy_ = stdext::bind(&dynamic::sleepFor, wait_, _1);
                 break;
+            case kPreciseSleepingStrategy:
+                wait_strategy_ = stdext::bind(&dynamic::sleepUntilDeadline,
+                                              wait_, timer_slack, _1);
+                break;
             case kYieldingStrategy:
                 wait_strategy_ = stdext::bind(&dynamic::yieldThis, _1);
                 break;
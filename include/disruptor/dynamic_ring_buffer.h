@@ -1,6 +1,9 @@
 #ifndef DISRUPTOR_DYNAMIC_RING_BUFFER_H_
 #define DISRUPTOR_DYNAMIC_RING_BUFFER_H_
 
+#include <algorithm>
+#include <iterator>
+
 #include <disruptor/sequencer.h>
 
 namespace disruptor {
@@ -8,6 +11,10 @@ namespace disruptor {
 // Ring based store of reusable entries containing the data representing an
 // event beign exchanged between publisher and {@link EventProcessor}s.
 //
+// Blocks are added as the producer outruns the consumer and recycled once
+// drained. They can grow geometrically, so a burst far bigger than the first
+// block takes a few large blocks instead of a long chain of small ones.
+//
 // @param <T> implementation storing the data for sharing during exchange
 // or parallel coordination of an event.
 template <typename T>
@@ -89,12 +96,18 @@ public:
     // @param claim_strategy_option is useless for this ringbuffer
     // @param wait_strategy_option waiting strategy employed by
     // processors_to_track waiting in entries becoming available.
+    // @param max_buffer_size every new block is twice as big as the
+    // previous one up to this size, 0 to keep every block at buffer_size.
     //
     DynamicRingBuffer(size_t buffer_size,
                ClaimStrategyOption claim_strategy_option,
                WaitStrategyOption wait_strategy_option,
-               const TimeConfig& timeConfig=TimeConfig())
+               const TimeConfig& timeConfig=TimeConfig(),
+               size_t max_buffer_size=0)
         : buffer_size_(ceilToPow2(buffer_size))
+        , max_buffer_size_(std::max(buffer_size_, ceilToPow2(max_buffer_size)))
+        , next_buffer_size_(std::min(buffer_size_ * 2, max_buffer_size_))
+        , capacity_(buffer_size_)
         , num_blocks_(1)
     {
         Block* first_block = new Block(buffer_size_);
@@ -147,7 +160,7 @@ public:
             }
             else {
                 // no other block available, create a new one
-                Block* new_block = new Block(buffer_size_);
+                Block* new_block = newBlock(1);
                 block_tail = new_block->tail_.get(stdext::memory_order_relaxed);
                 new_block->set(block_tail + 1, event);
                 new_block->advanceTail();
@@ -157,11 +170,71 @@ public:
 
                 stdext::atomic_thread_fence(stdext::memory_order_release);
                 tail_block_ = new_block;
-                ++num_blocks_;
             }
         }
     }
 
+    // Enqueue a range of events, filling the free span of each block with a
+    // single tail update instead of one per event.
+    //
+    // When a new block is needed it is sized for the rest of the range, up to
+    // max_buffer_size. The range is measured before it is copied, so it is
+    // walked twice: the iterators must be forward iterators at least, a
+    // single-pass input iterator such as std::istream_iterator won't do.
+    //
+    // @param first event of the range.
+    // @param last event, excluded.
+    template <typename ForwardIterator>
+    void enqueue_bulk(ForwardIterator first, ForwardIterator last)
+    {
+        size_t remaining = std::distance(first, last);
+        Block* tail = tail_block_.load(stdext::memory_order_relaxed);
+        stdext::atomic_thread_fence(stdext::memory_order_acquire);
+
+        while (remaining > 0) {
+            int64_t block_tail = tail->tail_.get(stdext::memory_order_relaxed);
+            int64_t block_head = tail->head_.get(stdext::memory_order_relaxed);
+            stdext::atomic_thread_fence(stdext::memory_order_acquire);
+
+            const size_t free = tail->size_ - (size_t)(block_tail - block_head);
+            const size_t count = std::min(free, remaining);
+            for (size_t i = 1; i <= count; ++i, ++first) {
+                tail->set(block_tail + i, *first);
+            }
+            if (count > 0) {
+                tail->advanceTailTo(count);
+                remaining -= count;
+            }
+            if (remaining == 0) {
+                break;
+            }
+
+            // the consumer moves on to a block only once it holds events, so
+            // the next one is published after it has been filled
+            Block* next = tail->next_.load(stdext::memory_order_relaxed);
+            if (next == front_block_.load(stdext::memory_order_relaxed)) {
+                next = newBlock(remaining);
+                next->next_ = tail->next_.load(stdext::memory_order_relaxed);
+                tail->next_ = next;
+            }
+            else {
+                stdext::atomic_thread_fence(stdext::memory_order_acquire);
+            }
+
+            block_tail = next->tail_.get(stdext::memory_order_relaxed);
+            const size_t next_count = std::min(next->size_, remaining);
+            for (size_t i = 1; i <= next_count; ++i, ++first) {
+                next->set(block_tail + i, *first);
+            }
+            next->advanceTailTo(next_count);
+            remaining -= next_count;
+
+            stdext::atomic_thread_fence(stdext::memory_order_release);
+            tail_block_ = next;
+            tail = next;
+        }
+    }
+
     bool dequeue(T& event)
     {
         // TODO: how do I read more than one elememnts without comparing
@@ -203,6 +276,46 @@ public:
         return true;
     }
 
+    // Allocate blocks up front until the buffer can hold at least capacity
+    // events, so a burst doesn't pay for the allocations.
+    //
+    // Must be called from the producer thread. New blocks are linked in right
+    // after the tail block, where enqueue would have put them.
+    //
+    // @param capacity the buffer should hold without allocating.
+    void reserve(size_t capacity)
+    {
+        while (capacity_ < capacity) {
+            Block* tail = tail_block_.load(stdext::memory_order_relaxed);
+            Block* new_block = newBlock(capacity - capacity_);
+            new_block->next_ = tail->next_.load(stdext::memory_order_relaxed);
+
+            stdext::atomic_thread_fence(stdext::memory_order_release);
+            tail->next_ = new_block;
+        }
+    }
+
+    // Pre-fault the events of every block, see {@link prefaultMemory}.
+    //
+    // Must be called from the producer thread.
+    //
+    // @param lock_memory also lock the events into RAM.
+    // @return false if locking was requested and failed for any block.
+    bool preFault(bool lock_memory = false)
+    {
+        bool result = true;
+        Block* first = tail_block_.load(stdext::memory_order_relaxed);
+        Block* block = first;
+        do {
+            result &= prefaultMemory(block->events_.get(),
+                                     block->size_ * sizeof(T),
+                                     lock_memory);
+            block = block->next_.load(stdext::memory_order_relaxed);
+        } while (block != first);
+
+        return result;
+    }
+
     size_t occupied_approx() const
     {
         size_t result = 0;
@@ -220,7 +333,7 @@ public:
 
     size_t available_approx() const
     {
-        return buffer_size_ * num_blocks_ - this->occupied_approx();
+        return capacity_ - this->occupied_approx();
     }
 
     size_t num_blocks() const
@@ -228,12 +341,32 @@ public:
         return num_blocks_;
     }
 
+    // Events all the blocks can hold together.
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
     bool has_available_capacity() const
     {
         return this->available_approx() > 0;
     }
 
 private:
+    // Allocate a block following the growth policy, not linked yet.
+    //
+    // @param wanted events the caller is about to write, the block is made
+    // big enough for them if max_buffer_size allows it.
+    Block* newBlock(size_t wanted)
+    {
+        const size_t size = std::max(next_buffer_size_,
+                                     std::min(ceilToPow2(wanted), max_buffer_size_));
+        next_buffer_size_ = std::min(size * 2, max_buffer_size_);
+        capacity_ += size;
+        ++num_blocks_;
+        return new Block(size);
+    }
+
     ALIGN(CACHE_LINE_SIZE_IN_BYTES);
     stdext::atomic<Block*> front_block_;
     char padding1_[CACHE_LINE_SIZE_IN_BYTES - sizeof(stdext::atomic<Block*>)];
@@ -242,7 +375,11 @@ private:
     stdext::atomic<Block*> tail_block_;
     char padding2_[CACHE_LINE_SIZE_IN_BYTES - sizeof(stdext::atomic<Block*>)];
 
-    const int buffer_size_;
+    const size_t buffer_size_;
+    const size_t max_buffer_size_;
+    // producer thread only
+    size_t next_buffer_size_;
+    size_t capacity_;
     size_t num_blocks_;
 };
 
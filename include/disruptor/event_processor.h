@@ -1,34 +1,151 @@
 #ifndef DISRUPTOR_EVENT_PROCESSOR_H_
 #define DISRUPTOR_EVENT_PROCESSOR_H_
 
+#include <string>
+
 #include <disruptor/ring_buffer.h>
 
 
 namespace disruptor {
 
+// Slots prefetched ahead of the one being handled, for events larger than a
+// cache line.
+const int64_t DEFAULT_PREFETCH_DISTANCE = 4;
+
+// Prefetch distance suited to an event type: small events share lines with
+// their neighbours and are already brought in by the hardware prefetcher.
+template <typename T>
+int64_t defaultPrefetchDistance()
+{
+    return sizeof(T) > CACHE_LINE_SIZE_IN_BYTES ? DEFAULT_PREFETCH_DISTANCE : 0;
+}
 
 template <typename T>
 class BatchEventProcessor : public IEventProcessor<T>
 {
 public:
+    // Publish time of an event, in nanoseconds on the CLOCK_MONOTONIC
+    // timeline, see {@link monotonicNanos}.
+    typedef stdext::function<int64_t (const T&)> TimestampFunction;
+
     BatchEventProcessor(RingBuffer<T>* ring_buffer,
                         SequenceBarrierPtr sequence_barrier,
                         IEventHandler<T>* event_handler,
                         IExceptionHandler<T>* exception_handler,
-                        const stdext::chrono::milliseconds& max_idle_time)
+                        const stdext::chrono::microseconds& max_idle_time)
         : running_(false)
         , ring_buffer_(ring_buffer)
         , sequence_barrier_(sequence_barrier)
         , event_handler_(event_handler)
         , exception_handler_(exception_handler)
         , wait_(max_idle_time)
+        , prefetch_distance_(defaultPrefetchDistance<T>())
+        , max_age_ns_(0)
+        , ordered_timestamps_(true)
+        , dropped_(0)
+        , min_batch_(1)
+        , max_linger_ns_(0)
+        , pending_handler_(NULL)
+        , pause_requested_(false)
+        , parked_(false)
+        , swap_failed_(false)
     {
     }
 
     virtual Sequence* getSequence() { return &sequence_; }
 
+    // Number of slots to prefetch ahead of the one being handled, 0 to turn
+    // prefetching off. Prefetching goes past the end of the batch into slots
+    // published since, but never past the cursor. Set before running.
+    //
+    // @param distance in slots, defaults to {@link defaultPrefetchDistance}.
+    void setPrefetchDistance(const int64_t& distance)
+    {
+        prefetch_distance_ = distance;
+    }
+
+    int64_t prefetchDistance() const { return prefetch_distance_; }
+
+    // Skip the events older than max_age instead of handling them, so that
+    // after a stall the backlog of stale events does not delay fresh ones.
+    // The stale events at the start of a batch are skipped at once, up to
+    // the first fresh one. Set before running.
+    //
+    // When publish times never decrease along the sequences, as with a single
+    // publisher stamping its events, the first fresh event is found by a
+    // binary search. Several publishers may publish out of timestamp order,
+    // a binary search could then skip fresh events: pass ordered as false to
+    // scan the batch linearly instead.
+    //
+    // @param timestamp reading the publish time of an event.
+    // @param max_age beyond which an event is dropped.
+    // @param ordered whether publish times never decrease along sequences.
+    void setStalenessPolicy(const TimestampFunction& timestamp,
+                            const stdext::chrono::microseconds& max_age,
+                            bool ordered = true)
+    {
+        timestamp_ = timestamp;
+        max_age_ns_ = (int64_t)max_age.count() * 1000;
+        ordered_timestamps_ = ordered;
+    }
+
+    // Number of stale events skipped so far.
+    int64_t dropped() const
+    {
+        return dropped_.load(stdext::memory_order_relaxed);
+    }
+
+    // Hold a batch back until min_batch events are available or max_delay
+    // has passed since the first of them was seen, whichever comes first.
+    // For handlers paying per batch rather than per event (fsync, compression,
+    // database writes), which would otherwise get batches of 1 under light
+    // load. The latency added to an event is bounded by max_delay. A
+    // min_batch of 1, the default, dispatches every batch right away. Set
+    // before running.
+    //
+    // @param min_batch events to wait for before dispatching.
+    // @param max_delay to wait for them at most.
+    void setLinger(const int64_t& min_batch,
+                   const stdext::chrono::microseconds& max_delay)
+    {
+        min_batch_ = std::max<int64_t>(min_batch, 1);
+        max_linger_ns_ = (int64_t)max_delay.count() * 1000;
+    }
+
     virtual void halt();
 
+    // Park the processor thread at the end of its current batch, without
+    // ending it. Returns once the thread is parked, or right away if it is
+    // not running, in which case it parks as soon as it starts unless resumed
+    // before. Other processors sharing the barrier are not disturbed.
+    //
+    // The sequence is held while paused: publishers and dependent processors
+    // stay gated on it and nothing is skipped on resume.
+    void pause();
+
+    // Wake a paused processor thread up, it carries on from its sequence.
+    void resume();
+
+    // Replace the event handler at the end of the current batch, without
+    // stopping the thread: the new handler gets onStart, then onTakeOver
+    // with the previous one, then the previous one gets onShutdown and is
+    // no longer called. An idle or paused thread is woken up to make the
+    // swap and stays paused. Returns once the previous handler is released,
+    // or right away if the processor is not running, in which case the swap
+    // happens as soon as it starts.
+    //
+    // @param handler to handle the events from the next batch on.
+    //
+    // @throws std::runtime_error if the new handler throws from onStart or
+    // onTakeOver, the previous handler then carries on.
+    void swapHandler(IEventHandler<T>* handler);
+
+    bool isPaused() const
+    {
+        stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+        return parked_;
+    }
+
     void operator() () { run(); }
 
 protected:
@@ -38,13 +155,43 @@ private:
     BatchEventProcessor(const BatchEventProcessor& b);
     BatchEventProcessor& operator= (BatchEventProcessor b);
 
+    void serveRequests();
+
+    void takeOverHandler(const int64_t& sequence);
+
+    int64_t skipStale(const int64_t& first, const int64_t& last);
+
+    int64_t linger(const int64_t& first, int64_t available);
+
+    int64_t prefetchAhead(const int64_t& sequence,
+                          int64_t prefetched,
+                          int64_t& limit,
+                          bool& peeked);
+
     stdext::atomic<bool>         running_;
     Sequence                     sequence_;
     RingBuffer<T>*               ring_buffer_;
-    SequenceBarrierPtr           sequence_barrier_; // barrier is (share)owned by processors
+    InterruptibleSequenceBarrier sequence_barrier_; // barrier is (share)owned by processors
     IEventHandler<T>*            event_handler_;
     IExceptionHandler<T>*        exception_handler_;
-    stdext::chrono::microseconds wait_; 
+    stdext::chrono::microseconds wait_;
+    int64_t                      prefetch_distance_;
+    TimestampFunction            timestamp_;
+    int64_t                      max_age_ns_;
+    bool                         ordered_timestamps_;
+    stdext::atomic<int64_t>      dropped_;
+    int64_t                      min_batch_;
+    int64_t                      max_linger_ns_;
+
+    stdext::atomic<IEventHandler<T>*> pending_handler_;
+
+    mutable stdext::mutex        control_mutex_;
+    stdext::condition_variable   control_condition_;
+    bool                         pause_requested_;
+    bool                         parked_;
+    // why the last takeover failed, for the caller of swapHandler
+    bool                         swap_failed_;
+    std::string                  swap_failure_;
 };
 
 
@@ -52,14 +199,203 @@ private:
 // implementation
 //
 
-void BatchEventProcessor::halt()
+template <typename T>
+void BatchEventProcessor<T>::halt()
 {
     running_.store(false);
-    sequence_barrier_->alert();
+    sequence_barrier_.alert();
+
+    // a halt overrides a pause, even one requested before the thread runs
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    pause_requested_ = false;
+    control_condition_.notify_all();
+}
+
+
+template <typename T>
+void BatchEventProcessor<T>::pause()
+{
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    pause_requested_ = true;
+    sequence_barrier_.interrupt();
+    while (running_.load() && !parked_) {
+        control_condition_.wait(ulock);
+    }
+}
+
+
+template <typename T>
+void BatchEventProcessor<T>::resume()
+{
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    pause_requested_ = false;
+    control_condition_.notify_all();
+}
+
+
+template <typename T>
+void BatchEventProcessor<T>::swapHandler(IEventHandler<T>* handler)
+{
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    swap_failed_ = false;
+    pending_handler_.store(handler, stdext::memory_order_release);
+    // the thread may be idle in a wait, or parked
+    sequence_barrier_.interrupt();
+    control_condition_.notify_all();
+    while (running_.load()
+            && pending_handler_.load(stdext::memory_order_acquire) != NULL) {
+        control_condition_.wait(ulock);
+    }
+    if (swap_failed_) {
+        swap_failed_ = false;
+        throw std::runtime_error("Handler swap failed: " + swap_failure_);
+    }
+}
+
+
+// Install the pending handler if any, on the processor thread between
+// batches, control_mutex_ held. If the new handler throws from onStart or
+// onTakeOver, the previous one is kept and the failure is left for the
+// caller of swapHandler: no event is skipped for it.
+//
+// @param sequence of the last event handled.
+template <typename T>
+void BatchEventProcessor<T>::takeOverHandler(const int64_t& sequence)
+{
+    IEventHandler<T>* handler =
+        pending_handler_.load(stdext::memory_order_acquire);
+    if (handler == NULL) {
+        return;
+    }
+    try {
+        handler->onStart();
+        handler->onTakeOver(sequence, event_handler_);
+    }
+    catch(const std::exception& e) {
+        swap_failed_ = true;
+        swap_failure_ = e.what();
+        pending_handler_.store(NULL, stdext::memory_order_release);
+        control_condition_.notify_all();
+        return;
+    }
+    IEventHandler<T>* previous = event_handler_;
+    event_handler_ = handler;
+    previous->onShutdown();
+
+    pending_handler_.store(NULL, stdext::memory_order_release);
+    control_condition_.notify_all();
+}
+
+
+// Serve the requests that interrupted a wait: install a swapped handler,
+// and park the thread until resumed, still installing the handlers swapped
+// meanwhile. The interrupt may be stale, from a request already served.
+template <typename T>
+void BatchEventProcessor<T>::serveRequests()
+{
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    // requests made from now on interrupt the next wait
+    sequence_barrier_.clearInterrupt();
+    const int64_t sequence = sequence_.get();
+    takeOverHandler(sequence);
+    if (!pause_requested_) {
+        return;
+    }
+
+    parked_ = true;
+    control_condition_.notify_all();
+    while (pause_requested_) {
+        control_condition_.wait(ulock);
+        takeOverHandler(sequence);
+    }
+    parked_ = false;
 }
 
 
-void BatchEventProcessor::run()
+// Find the first event of a batch that is not stale.
+//
+// @return its sequence, last + 1 if the whole batch is stale.
+template <typename T>
+int64_t BatchEventProcessor<T>::skipStale(const int64_t& first,
+                                          const int64_t& last)
+{
+    const int64_t oldest_fresh = monotonicNanos() - max_age_ns_;
+    if (timestamp_(*ring_buffer_->get(first)) >= oldest_fresh) {
+        return first;
+    }
+
+    int64_t low = first + 1;
+    if (ordered_timestamps_) {
+        int64_t high = last + 1;
+        while (low < high) {
+            int64_t middle = low + (high - low) / 2;
+            if (timestamp_(*ring_buffer_->get(middle)) < oldest_fresh) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+    }
+    else {
+        while (low <= last
+                && timestamp_(*ring_buffer_->get(low)) < oldest_fresh) {
+            ++low;
+        }
+    }
+
+    dropped_.fetch_add(low - first, stdext::memory_order_relaxed);
+    return low;
+}
+
+
+// Wait for the batch starting at first to reach min_batch_ events, until
+// max_linger_ns_ from now.
+//
+// @return last sequence available.
+template <typename T>
+int64_t BatchEventProcessor<T>::linger(const int64_t& first,
+                                       int64_t available)
+{
+    const int64_t wanted = first + min_batch_ - 1;
+    const int64_t deadline = monotonicNanos() + max_linger_ns_;
+    int64_t remaining;
+    while (available < wanted
+            && (remaining = deadline - monotonicNanos()) > 0) {
+        available = std::max(available, sequence_barrier_.waitFor(wanted,
+                    stdext::chrono::microseconds((remaining + 999) / 1000)));
+    }
+    return available;
+}
+
+
+// Prefetch the slots up to prefetch_distance_ ahead of sequence that are
+// not prefetched yet. Once the end of the batch is reached, the cursor is
+// read once to carry on into the next batch.
+//
+// @return last sequence prefetched.
+template <typename T>
+int64_t BatchEventProcessor<T>::prefetchAhead(const int64_t& sequence,
+                                              int64_t prefetched,
+                                              int64_t& limit,
+                                              bool& peeked)
+{
+    const int64_t ahead = sequence + prefetch_distance_;
+    if (ahead > limit && !peeked) {
+        limit = std::max(limit, sequence_barrier_.getAvailableSequence());
+        peeked = true;
+    }
+
+    const int64_t last = std::min(ahead, limit);
+    while (prefetched < last) {
+        ring_buffer_->prefetch(++prefetched);
+    }
+    return prefetched;
+}
+
+
+template <typename T>
+void BatchEventProcessor<T>::run()
 {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true)) {
@@ -68,20 +404,36 @@ void BatchEventProcessor::run()
 
     // Note: must keep this line commented, otherwise, if Halt is called
     // before clearAlert, then the alert status will never be caught
-    //sequence_barrier_->clearAlert();
+    //sequence_barrier_.clearAlert();
     event_handler_->onStart();
 
     T* event = NULL;
     int64_t next_sequence = sequence_.get() + 1L;
+    int64_t prefetched = next_sequence;
 
     while (true) {
         try {
             int64_t available_sequence =
-                sequence_barrier_->waitFor(next_sequence, wait_);
+                sequence_barrier_.waitFor(next_sequence, wait_);
+
+            if (min_batch_ > 1 && next_sequence <= available_sequence) {
+                available_sequence = linger(next_sequence, available_sequence);
+            }
+
+            if (timestamp_ && next_sequence <= available_sequence) {
+                next_sequence = skipStale(next_sequence, available_sequence);
+            }
 
             int64_t batch_size = available_sequence - next_sequence + 1;
+            int64_t prefetch_limit = available_sequence;
+            bool peeked = false;
+            prefetched = std::max(prefetched, next_sequence);
 
             while (next_sequence <= available_sequence) {
+                if (prefetch_distance_ > 0) {
+                    prefetched = prefetchAhead(next_sequence, prefetched,
+                                               prefetch_limit, peeked);
+                }
                 event = ring_buffer_->get(next_sequence);
                 event_handler_->onEvent(next_sequence,
                         batch_size,
@@ -89,7 +441,7 @@ void BatchEventProcessor::run()
                 next_sequence++;
             }
 
-            if (wait_.ticks() != 0) {
+            if (wait_.count() != 0) {
                 // not matter there was events or not, always notify handler
                 // with NULL event for special handling
                 event_handler_->onEvent(next_sequence,
@@ -99,21 +451,34 @@ void BatchEventProcessor::run()
             }
 
             sequence_.set(next_sequence - 1L);
+            ring_buffer_->signal(sequence_);
+
+            if (pending_handler_.load(stdext::memory_order_relaxed) != NULL) {
+                stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+                takeOverHandler(next_sequence - 1L);
+            }
         }
         catch(const AlertException& e) {
-            break;
+            if (sequence_barrier_.isSharedAlerted()) {
+                break;
+            }
+            serveRequests();
         }
         catch(const std::exception& e) {
             if (exception_handler_) {
                 exception_handler_->handle(e, next_sequence, event);
             }
             sequence_.set(next_sequence);
+            ring_buffer_->signal(sequence_);
             next_sequence++;
         }
     }
 
     event_handler_->onShutdown();
     running_.store(false);
+
+    stdext::unique_lock<stdext::mutex> ulock(control_mutex_);
+    control_condition_.notify_all();
 }
 
 }
@@ -2,6 +2,7 @@
 #define DISRUPTOR_EVENT_PUBLISHER_H_
 
 #include <disruptor/ring_buffer.h>
+#include <disruptor/latency_histogram.h>
 
 namespace disruptor {
 
@@ -11,22 +12,53 @@ class EventPublisher
 public:
     EventPublisher(RingBuffer<T>* ring_buffer)
         : ring_buffer_(ring_buffer)
+        , write_prefetch_distance_(0)
     {
     }
 
+    // Number of slots past the claimed one to prefetch for write on each
+    // publish, 0 (the default) to turn it off. Meant for a single publisher
+    // of events spanning many cache lines: the next slots are then owned by
+    // the publisher by the time it claims them. Set before publishing.
+    //
+    // @param distance in slots.
+    void setWritePrefetchDistance(const int64_t& distance)
+    {
+        write_prefetch_distance_ = distance;
+    }
+
     void publishEvent(IEventTranslator<T>* translator)
     {
-        int64_t sequence = ring_buffer_->next();
+        int64_t sequence = claim();
         // this is where time stamp generated
         translator->translateTo(sequence, ring_buffer_->get(sequence));
         ring_buffer_->publish(sequence);
     }
 
+    // Same as above, also recording how long the publisher waited on the
+    // ring: to claim the slot, then for the publishers ahead of it before
+    // the cursor could move. The translation is not counted. Give each
+    // publisher thread its own histogram to compare them.
+    //
+    // @param latency receives the wait in nanoseconds.
+    void publishEvent(IEventTranslator<T>* translator,
+                      LatencyHistogram* latency)
+    {
+        const int64_t claim_start = monotonicNanos();
+        int64_t sequence = claim();
+        const int64_t claimed = monotonicNanos();
+        translator->translateTo(sequence, ring_buffer_->get(sequence));
+        const int64_t publish_start = monotonicNanos();
+        ring_buffer_->publish(sequence);
+        latency->record(claimed - claim_start
+                        + monotonicNanos() - publish_start);
+    }
+
 
     bool tryPublishEvent(IEventTranslator<T>* translator)
     {
         if (ring_buffer_->hasAvailableCapacity()) {
-            int64_t sequence = ring_buffer_->next();
+            int64_t sequence = claim();
             translator->translateTo(sequence, ring_buffer_->get(sequence));
             ring_buffer_->publish(sequence);
             return true;
@@ -41,7 +73,21 @@ public:
     }
 
 private:
+    // Claim the next slot, prefetching the one write_prefetch_distance_
+    // slots ahead if asked to.
+    //
+    // @return the claimed sequence.
+    int64_t claim()
+    {
+        int64_t sequence = ring_buffer_->next();
+        if (write_prefetch_distance_ > 0) {
+            ring_buffer_->prefetchForWrite(sequence + write_prefetch_distance_);
+        }
+        return sequence;
+    }
+
     RingBuffer<T>* ring_buffer_;
+    int64_t        write_prefetch_distance_;
 };
 
 }
@@ -0,0 +1,319 @@
+#ifndef DISRUPTOR_LANE_DISRUPTOR_H_
+#define DISRUPTOR_LANE_DISRUPTOR_H_
+
+#include <disruptor/disruptor.h>
+
+namespace disruptor {
+
+const int DEFAULT_LANE_BATCH_SIZE = 64;
+
+// Handle of a producer registered with a {@link LaneDisruptor}, to be used
+// by a single thread.
+template <typename T>
+class ProducerToken
+{
+public:
+    ProducerToken()
+        : lane_(NULL)
+        , index_(0)
+    {
+    }
+
+    size_t index() const { return index_; }
+
+private:
+    template <typename> friend class LaneProcessor;
+    template <typename> friend class LaneDisruptor;
+
+    RingBuffer<T>* lane_;
+    size_t         index_;
+};
+
+// Consumes the lanes of a {@link LaneDisruptor} as a single stream.
+//
+// Lanes are visited round robin and each visit takes at most max_batch
+// events, so a busy producer cannot starve the others. The handler sees the
+// events of a lane in publication order, but events of different lanes are
+// interleaved by visit. The sequence passed to the handler counts the events
+// of the merged stream.
+template <typename T>
+class LaneProcessor : public IEventProcessor<T>
+{
+public:
+    LaneProcessor(const std::vector< RingBuffer<T>* >& lanes,
+                  const stdext::atomic<size_t>& registered,
+                  WaitStrategyOption waitStrategy,
+                  IEventHandler<T>* event_handler,
+                  IExceptionHandler<T>* exception_handler,
+                  const stdext::chrono::microseconds& max_idle_time,
+                  int64_t max_batch,
+                  const stdext::chrono::microseconds& timer_slack =
+                      stdext::chrono::microseconds(DEFAULT_TIMER_SLACK_US))
+        : running_(false)
+        , lanes_(lanes)
+        , registered_(registered)
+        , lane_sequences_(new Sequence[lanes.size()])
+        , event_handler_(event_handler)
+        , exception_handler_(exception_handler)
+        , wait_(max_idle_time)
+        , max_batch_(max_batch)
+        , retries_(MAX_RETRIES_TIMES)
+    {
+        switch (waitStrategy) {
+            case kSleepingStrategy:
+                wait_strategy_ = stdext::bind(&dynamic::sleepFor, wait_, _1);
+                break;
+            case kPreciseSleepingStrategy:
+                wait_strategy_ = stdext::bind(&dynamic::sleepUntilDeadline,
+                                              wait_, timer_slack, _1);
+                break;
+            case kYieldingStrategy:
+            case kBlockingStrategy:
+            case kBusySpinStrategy:
+                // not supported, fall through
+            default:
+                wait_strategy_ = stdext::bind(&dynamic::yieldThis, _1);
+                break;
+        }
+    }
+
+    // Sequence of the last event handled in the merged stream.
+    virtual Sequence* getSequence() { return &sequence_; }
+
+    // Sequence gating the given lane.
+    Sequence* getLaneSequence(size_t lane) { return &lane_sequences_[lane]; }
+
+    virtual void halt()
+    {
+        running_.store(false);
+    }
+
+    void operator() () { run(); }
+
+private:
+    LaneProcessor(const LaneProcessor&);
+    LaneProcessor& operator= (const LaneProcessor&);
+
+    void run()
+    {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::runtime_error("Thread is already running");
+        }
+
+        event_handler_->onStart();
+
+        while (running_.load(stdext::memory_order_relaxed)) {
+            int64_t handled = 0;
+            const size_t lanes = registered_.load(stdext::memory_order_acquire);
+            for (size_t i = 0; i < lanes; ++i) {
+                handled += drain(i);
+            }
+
+            if (handled == 0) {
+                if (wait_strategy_(retries_)) {
+                    retries_ = MAX_RETRIES_TIMES;
+                    if (wait_.count() != 0) {
+                        // notify handler with NULL event when idle
+                        event_handler_->onEvent(sequence_.get() + 1L, 0,
+                                                false, NULL);
+                    }
+                }
+            }
+            else {
+                retries_ = MAX_RETRIES_TIMES;
+            }
+        }
+
+        event_handler_->onShutdown();
+        running_.store(false);
+    }
+
+    // Handle up to max_batch_ events of a lane.
+    //
+    // @return number of events handled.
+    int64_t drain(size_t lane)
+    {
+        Sequence& lane_sequence = lane_sequences_[lane];
+        const int64_t first = lane_sequence.get() + 1L;
+        const int64_t available = std::min(lanes_[lane]->getCursor(),
+                                           first + max_batch_ - 1);
+        if (available < first) {
+            return 0;
+        }
+
+        const int64_t batch_size = available - first + 1;
+        int64_t sequence = sequence_.get();
+        for (int64_t lane_sequence_value = first;
+                lane_sequence_value <= available; ++lane_sequence_value) {
+            T* event = lanes_[lane]->get(lane_sequence_value);
+            ++sequence;
+            try {
+                event_handler_->onEvent(sequence, batch_size,
+                                        lane_sequence_value == available,
+                                        event);
+            }
+            catch(const std::exception& e) {
+                if (exception_handler_) {
+                    exception_handler_->handle(e, sequence, event);
+                }
+            }
+        }
+
+        sequence_.set(sequence);
+        lane_sequence.set(available);
+        lanes_[lane]->signal(lane_sequence);
+        return batch_size;
+    }
+
+    stdext::atomic<bool>                 running_;
+    Sequence                             sequence_;
+    const std::vector< RingBuffer<T>* >& lanes_;
+    const stdext::atomic<size_t>&        registered_;
+#ifdef has_cplusplus11
+    std::unique_ptr<Sequence[]>          lane_sequences_;
+#else
+    boost::scoped_array<Sequence>        lane_sequences_;
+#endif
+    dynamic::WaitStrategy                wait_strategy_;
+    IEventHandler<T>*                    event_handler_;
+    IExceptionHandler<T>*                exception_handler_;
+    stdext::chrono::microseconds         wait_;
+    const int64_t                        max_batch_;
+    int                                  retries_;
+};
+
+// has similar interface as the normal Disruptor, but with the following differences:
+// - every producer registers first and publishes through its own token
+// - each token owns a single producer lane, producers never share a cache line
+// - the consumer merges the lanes fairly, there is no order across producers
+//
+// For many producers feeding one consumer when the global publication order
+// does not matter, instead of contending on a multi threaded claim strategy.
+template <typename T>
+class LaneDisruptor
+{
+    public:
+        // will start after construct
+        //
+        // @param size of each lane, rounded up to a power of 2.
+        // @param max_producers number of tokens that can be registered.
+        // @param max_batch events taken from a lane before visiting the next.
+        LaneDisruptor(int64_t size,
+                      size_t max_producers,
+                      WaitStrategyOption waitStrategy,
+                      IEventHandler<T> * handler,
+                      IExceptionHandler<T> * exceptHandler,
+                      const TimeConfig& timeConfig = TimeConfig(),
+                      int64_t max_batch = DEFAULT_LANE_BATCH_SIZE)
+            : lanes_(createLanes(size, max_producers))
+            , tokens_(max_producers)
+            , registered_(0)
+            , processor_(lanes_, registered_, waitStrategy, handler,
+                         exceptHandler,
+                         getTimeConfig(timeConfig, kMaxIdle,
+                                       stdext::chrono::microseconds(
+                                           DEFAULT_MAX_IDLE_TIME_US)),
+                         max_batch,
+                         getTimeConfig(timeConfig, kTimerSlack,
+                                       stdext::chrono::microseconds(
+                                           DEFAULT_TIMER_SLACK_US)))
+            , stopped_(false)
+        {
+            for (size_t i = 0; i < lanes_.size(); ++i) {
+                lanes_[i]->setGatingSequences(
+                        DependentSequences(1, processor_.getLaneSequence(i)));
+                tokens_[i].lane_ = lanes_[i];
+                tokens_[i].index_ = i;
+            }
+            stdext::thread consumer_thread(
+                    stdext::ref< LaneProcessor<T> >(processor_));
+            consumer_thread_.swap(consumer_thread);
+        }
+
+        virtual ~LaneDisruptor()
+        {
+            if (!stopped_) {
+                this->stop();
+            }
+            for (size_t i = 0; i < lanes_.size(); ++i) {
+                delete lanes_[i];
+            }
+        }
+
+        // Register a producer and hand it its lane.
+        //
+        // @return token to publish with, from the registering thread only.
+        // @throws std::runtime_error if max_producers are registered.
+        ProducerToken<T>* registerProducer()
+        {
+            stdext::unique_lock<stdext::mutex> ulock(register_mutex_);
+            size_t index = registered_.load(stdext::memory_order_relaxed);
+            if (index == tokens_.size()) {
+                throw std::runtime_error("Too many producers registered");
+            }
+            registered_.store(index + 1, stdext::memory_order_release);
+            return &tokens_[index];
+        }
+
+        void publishEvent(ProducerToken<T>* token,
+                          IEventTranslator<T>* translator)
+        {
+            RingBuffer<T>* lane = token->lane_;
+            int64_t sequence = lane->next();
+            translator->translateTo(sequence, lane->get(sequence));
+            lane->publish(sequence);
+        }
+
+        bool tryPublishEvent(ProducerToken<T>* token,
+                             IEventTranslator<T>* translator)
+        {
+            if (!token->lane_->hasAvailableCapacity()) {
+                return false;
+            }
+            publishEvent(token, translator);
+            return true;
+        }
+
+        bool full(ProducerToken<T>* token) const
+        {
+            return !token->lane_->hasAvailableCapacity();
+        }
+
+        LaneProcessor<T>& processor()
+        {
+            return processor_;
+        }
+
+        void stop()
+        {
+            processor_.halt();
+            consumer_thread_.join();
+            stopped_ = true;
+        }
+
+    private:
+        static std::vector< RingBuffer<T>* > createLanes(int64_t size,
+                                                         size_t count)
+        {
+            std::vector< RingBuffer<T>* > lanes(count);
+            for (size_t i = 0; i < count; ++i) {
+                // the consumer polls, the lanes never signal
+                lanes[i] = new RingBuffer<T>(size, kSingleThreadedStrategy,
+                                             kBusySpinStrategy, TimeConfig());
+            }
+            return lanes;
+        }
+
+        const std::vector< RingBuffer<T>* > lanes_;
+        std::vector< ProducerToken<T> >     tokens_;
+        stdext::mutex                       register_mutex_;
+        stdext::atomic<size_t>              registered_;
+        LaneProcessor<T>                    processor_;
+        stdext::thread                      consumer_thread_;
+        bool                                stopped_;
+};
+
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef DISRUPTOR_LATENCY_HISTOGRAM_H_
+#define DISRUPTOR_LATENCY_HISTOGRAM_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace disruptor {
+
+// Sub-buckets per power of two, bounds the error of a percentile to 1/8.
+const int LATENCY_SUB_BUCKET_BITS = 3;
+
+// Log-linear histogram of latencies in nanoseconds, cheap enough to record
+// every event on a hot path.
+//
+// Values are counted in buckets covering each power of two split in 8, so
+// recording is a few instructions and percentiles far in the tail (p99.9,
+// p99.99) stay within 12.5% of the exact value whatever their magnitude.
+//
+// Not thread safe: give each recording thread its own histogram and
+// {@link merge} them once they are done.
+class LatencyHistogram
+{
+public:
+    static const int kSubBuckets = 1 << LATENCY_SUB_BUCKET_BITS;
+    static const int kBuckets = (64 - LATENCY_SUB_BUCKET_BITS + 1) * kSubBuckets;
+
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record(int64_t nanos)
+    {
+        if (nanos < 0) {
+            nanos = 0;
+        }
+        ++counts_[bucketOf(nanos)];
+        ++count_;
+        total_ += nanos;
+        max_ = std::max(max_, nanos);
+    }
+
+    void merge(const LatencyHistogram& other)
+    {
+        for (int i = 0; i < kBuckets; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset()
+    {
+        memset(counts_, 0, sizeof(counts_));
+        count_ = 0;
+        total_ = 0;
+        max_ = 0;
+    }
+
+    int64_t count() const { return count_; }
+
+    int64_t max() const { return max_; }
+
+    double mean() const
+    {
+        return count_ == 0 ? 0.0 : (double)total_ / count_;
+    }
+
+    // Smallest recorded latency at least a fraction of the values are lower
+    // than or equal to, rounded up to its bucket.
+    //
+    // @param fraction between 0 and 1, e.g. 0.999 for the p99.9.
+    // @return latency in nanoseconds, 0 if nothing was recorded.
+    int64_t percentile(double fraction) const
+    {
+        const int64_t rank = std::max<int64_t>(1,
+                static_cast<int64_t>(fraction * count_ + 0.999999));
+        int64_t seen = 0;
+        for (int i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(upperBoundOf(i), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    static int bucketOf(int64_t nanos)
+    {
+        const uint64_t value = nanos;
+        if (value < (uint64_t)kSubBuckets) {
+            return value;
+        }
+        const int msb = 63 - __builtin_clzll(value);
+        const int shift = msb - LATENCY_SUB_BUCKET_BITS;
+        return (shift + 1) * kSubBuckets + ((value >> shift) & (kSubBuckets - 1));
+    }
+
+    static int64_t upperBoundOf(int bucket)
+    {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const int shift = bucket / kSubBuckets - 1;
+        const uint64_t lower = (uint64_t)(kSubBuckets + bucket % kSubBuckets) << shift;
+        return lower + ((uint64_t)1 << shift) - 1;
+    }
+
+    int64_t counts_[kBuckets];
+    int64_t count_;
+    int64_t total_;
+    int64_t max_;
+};
+
+}
+
+#endif
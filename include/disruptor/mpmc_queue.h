@@ -0,0 +1,231 @@
+#ifndef DISRUPTOR_MPMC_QUEUE_H_
+#define DISRUPTOR_MPMC_QUEUE_H_
+
+#include <algorithm>
+
+#include <disruptor/sequence.h>
+
+namespace disruptor {
+
+const int DEFAULT_QUEUE_RETRIES = 100;
+
+// Bounded multi-producer multi-consumer queue with value semantics, for those
+// who need push/pop rather than a {@link RingBuffer} with processors.
+//
+// Same power-of-2 layout as the {@link RingBuffer}, but every slot carries its
+// own turn counter instead of gating on consumer sequences (D. Vyukov's
+// bounded MPMC queue): slot i is free for the producer at position p when
+// its turn is p, and full for the consumer at position p when its turn is
+// p + 1. Producers and consumers each race on one shared position with a CAS,
+// bulk operations claim a whole run of slots with a single CAS.
+//
+// T must be default constructible and assignable.
+template <typename T>
+class MpmcQueue : private stdext::noncopyable
+{
+public:
+    // @param capacity of the queue, rounded up to a power of 2 and at least
+    // 2: with a single slot, its free turn for the next lap would be the full
+    // turn of the current one.
+    explicit MpmcQueue(size_t capacity)
+        : capacity_(ceilToPow2(std::max<size_t>(capacity, 2)))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_])
+        , enqueue_position_(0)
+        , dequeue_position_(0)
+    {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].turn_.store(i, stdext::memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Number of values in the queue, only an indication under concurrency.
+    size_t size_approx() const
+    {
+        int64_t size = enqueue_position_.get(stdext::memory_order_relaxed)
+            - dequeue_position_.get(stdext::memory_order_relaxed);
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    bool try_push(const T& value)
+    {
+        return try_push(&value, 1) == 1;
+    }
+
+    bool try_pop(T& value)
+    {
+        return try_pop(&value, 1) == 1;
+    }
+
+    // Push a value, spinning then yielding while the queue is full.
+    void push(const T& value)
+    {
+        int counter = DEFAULT_QUEUE_RETRIES;
+        while (!try_push(value)) {
+            counter = backOff(counter);
+        }
+    }
+
+    // Pop a value, spinning then yielding while the queue is empty.
+    T pop()
+    {
+        T value;
+        int counter = DEFAULT_QUEUE_RETRIES;
+        while (!try_pop(value)) {
+            counter = backOff(counter);
+        }
+        return value;
+    }
+
+    // Push as many of the values as there are free slots in a row.
+    //
+    // @param values to push, in order.
+    // @param count of values.
+    // @return number of values pushed, 0 if the queue is full.
+    size_t try_push(const T* values, size_t count)
+    {
+        int64_t position = enqueue_position_.get(stdext::memory_order_relaxed);
+        while (true) {
+            size_t claimable = countReady(position, count, 0);
+            if (claimable == 0) {
+                int64_t turn = cell(position).turn_.load(stdext::memory_order_acquire);
+                if (turn < position) {
+                    // the slot still holds the value of the previous lap
+                    return 0;
+                }
+                position = enqueue_position_.get(stdext::memory_order_relaxed);
+                continue;
+            }
+
+            if (enqueue_position_.compareAndExchange(position,
+                        position + claimable, stdext::memory_order_relaxed)) {
+                for (size_t i = 0; i < claimable; ++i) {
+                    Cell& c = cell(position + i);
+                    c.value_ = values[i];
+                    c.turn_.store(position + i + 1, stdext::memory_order_release);
+                }
+                return claimable;
+            }
+            position = enqueue_position_.get(stdext::memory_order_relaxed);
+        }
+    }
+
+    // Pop as many values as there are full slots in a row, up to count.
+    //
+    // @param values receives the values, in order.
+    // @param count maximum number of values.
+    // @return number of values popped, 0 if the queue is empty.
+    size_t try_pop(T* values, size_t count)
+    {
+        int64_t position = dequeue_position_.get(stdext::memory_order_relaxed);
+        while (true) {
+            size_t claimable = countReady(position, count, 1);
+            if (claimable == 0) {
+                int64_t turn = cell(position).turn_.load(stdext::memory_order_acquire);
+                if (turn < position + 1) {
+                    // nothing published at this position yet
+                    return 0;
+                }
+                position = dequeue_position_.get(stdext::memory_order_relaxed);
+                continue;
+            }
+
+            if (dequeue_position_.compareAndExchange(position,
+                        position + claimable, stdext::memory_order_relaxed)) {
+                for (size_t i = 0; i < claimable; ++i) {
+                    Cell& c = cell(position + i);
+                    values[i] = c.value_;
+                    c.turn_.store(position + i + capacity_,
+                                  stdext::memory_order_release);
+                }
+                return claimable;
+            }
+            position = dequeue_position_.get(stdext::memory_order_relaxed);
+        }
+    }
+
+    // Push all the values, waiting for free slots as needed.
+    void push(const T* values, size_t count)
+    {
+        int counter = DEFAULT_QUEUE_RETRIES;
+        while (count > 0) {
+            size_t pushed = try_push(values, count);
+            if (pushed == 0) {
+                counter = backOff(counter);
+            }
+            values += pushed;
+            count -= pushed;
+        }
+    }
+
+    // Pop count values, waiting for full slots as needed.
+    void pop(T* values, size_t count)
+    {
+        int counter = DEFAULT_QUEUE_RETRIES;
+        while (count > 0) {
+            size_t popped = try_pop(values, count);
+            if (popped == 0) {
+                counter = backOff(counter);
+            }
+            values += popped;
+            count -= popped;
+        }
+    }
+
+private:
+    struct Cell
+    {
+        stdext::atomic<int64_t> turn_;
+        T value_;
+    };
+
+    Cell& cell(int64_t position)
+    {
+        return cells_[position & mask_];
+    }
+
+    // Number of slots in a row from position whose turn is position + offset,
+    // offset being 0 for free slots and 1 for full ones.
+    size_t countReady(int64_t position, size_t count, int64_t offset)
+    {
+        if (count > capacity_) {
+            count = capacity_;
+        }
+
+        size_t ready = 0;
+        while (ready < count
+                && cell(position + ready).turn_.load(stdext::memory_order_acquire)
+                    == position + (int64_t)ready + offset) {
+            ++ready;
+        }
+        return ready;
+    }
+
+    int backOff(int counter)
+    {
+        if (counter > 0) {
+            --counter;
+        }
+        else {
+            stdext::this_thread::yield();
+        }
+        return counter;
+    }
+
+    const size_t capacity_;
+    const int64_t mask_;
+#ifdef has_cplusplus11
+    std::unique_ptr<Cell[]> cells_;
+#else
+    boost::scoped_array<Cell> cells_;
+#endif
+
+    Sequence enqueue_position_;
+    Sequence dequeue_position_;
+};
+
+}
+
+#endif
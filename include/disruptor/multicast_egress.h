@@ -0,0 +1,233 @@
+#ifndef DISRUPTOR_MULTICAST_EGRESS_H_
+#define DISRUPTOR_MULTICAST_EGRESS_H_
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <disruptor/interface.h>
+
+namespace disruptor {
+
+const size_t DEFAULT_EGRESS_BATCH_SIZE = 64;
+// Largest UDP payload that fits an ethernet frame without fragmenting.
+const size_t DEFAULT_MAX_DATAGRAM_SIZE = 1472;
+
+// Where and how a {@link MulticastEgressHandler} sends.
+struct MulticastConfig
+{
+    MulticastConfig(const std::string& group, uint16_t port)
+        : group_(group)
+        , port_(port)
+        , interface_("0.0.0.0")
+        , ttl_(1)
+        , loopback_(true)
+        , max_batch_(DEFAULT_EGRESS_BATCH_SIZE)
+        , max_datagram_(DEFAULT_MAX_DATAGRAM_SIZE)
+    {
+    }
+
+    std::string group_;
+    uint16_t    port_;
+    // address of the outgoing interface, any by default.
+    std::string interface_;
+    int         ttl_;
+    // whether local receivers get the datagrams too.
+    bool        loopback_;
+    // datagrams sent by one sendmmsg at most.
+    size_t      max_batch_;
+    size_t      max_datagram_;
+};
+
+// Event handler sending every event as one UDP multicast datagram.
+//
+// Events are encoded into preallocated datagram buffers as they come, and
+// the datagrams of a batch go out in a single sendmmsg(2) call, on the end of
+// the batch or when max_batch datagrams are pending, whichever comes first.
+// So a backlog of N events costs about N / max_batch system calls instead of
+// N, see {@link packetsPerSyscall}.
+//
+// The socket is opened in onStart and closed in onShutdown, on the processor
+// thread.
+//
+// @param <T> event type.
+template <typename T>
+class MulticastEgressHandler : public IEventHandler<T>
+{
+public:
+    // Encode an event into a datagram.
+    //
+    // @return size of the datagram, 0 to send nothing for this event. A size
+    // above capacity drops the event and counts as an error.
+    typedef stdext::function<size_t (const T& event,
+                                     char* buffer,
+                                     size_t capacity)> Encoder;
+
+    MulticastEgressHandler(const MulticastConfig& config,
+                           const Encoder& encoder)
+        : config_(config)
+        , encoder_(encoder)
+        , socket_(-1)
+        , buffers_(config.max_batch_ * config.max_datagram_)
+        , iovecs_(config.max_batch_)
+        , messages_(config.max_batch_)
+        , pending_(0)
+        , packets_(0)
+        , syscalls_(0)
+        , errors_(0)
+    {
+        memset(&destination_, 0, sizeof(destination_));
+        destination_.sin_family = AF_INET;
+        destination_.sin_port = htons(config.port_);
+        if (inet_pton(AF_INET, config.group_.c_str(),
+                      &destination_.sin_addr) != 1) {
+            throw std::invalid_argument("Invalid multicast group "
+                                        + config.group_);
+        }
+
+        for (size_t i = 0; i < config.max_batch_; ++i) {
+            iovecs_[i].iov_base = &buffers_[i * config.max_datagram_];
+            memset(&messages_[i], 0, sizeof(messages_[i]));
+            messages_[i].msg_hdr.msg_name = &destination_;
+            messages_[i].msg_hdr.msg_namelen = sizeof(destination_);
+            messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+            messages_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    virtual ~MulticastEgressHandler()
+    {
+        closeSocket();
+    }
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         T* event)
+    {
+        if (event == NULL) {
+            // idle, nothing should linger
+            flush();
+            return;
+        }
+
+        size_t length = encoder_(*event,
+                                 &buffers_[pending_ * config_.max_datagram_],
+                                 config_.max_datagram_);
+        if (length > config_.max_datagram_) {
+            // sending it would read past the buffer of the datagram
+            ++errors_;
+        }
+        else if (length > 0) {
+            iovecs_[pending_].iov_len = length;
+            ++pending_;
+        }
+
+        if (end_of_batch || pending_ == config_.max_batch_) {
+            flush();
+        }
+    }
+
+    virtual void onStart()
+    {
+        closeSocket();
+        socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_ < 0) {
+            throw std::runtime_error(std::string("socket: ") + strerror(errno));
+        }
+
+        struct in_addr interface;
+        unsigned char ttl = static_cast<unsigned char>(config_.ttl_);
+        unsigned char loopback = config_.loopback_ ? 1 : 0;
+        if (inet_pton(AF_INET, config_.interface_.c_str(), &interface) != 1
+                || setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF,
+                              &interface, sizeof(interface)) != 0
+                || setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL,
+                              &ttl, sizeof(ttl)) != 0
+                || setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP,
+                              &loopback, sizeof(loopback)) != 0) {
+            std::string error = strerror(errno);
+            closeSocket();
+            throw std::runtime_error("multicast socket options: " + error);
+        }
+    }
+
+    virtual void onShutdown()
+    {
+        flush();
+        closeSocket();
+    }
+
+    // Statistics are kept by the processor thread, read them once stopped.
+
+    // Datagrams sent so far.
+    int64_t packets() const { return packets_; }
+
+    // sendmmsg calls made so far.
+    int64_t syscalls() const { return syscalls_; }
+
+    // Datagrams dropped because sendmmsg failed or they were oversized.
+    int64_t errors() const { return errors_; }
+
+    double packetsPerSyscall() const
+    {
+        return syscalls_ == 0 ? 0.0 : (double)packets_ / syscalls_;
+    }
+
+private:
+    MulticastEgressHandler(const MulticastEgressHandler&);
+    MulticastEgressHandler& operator= (const MulticastEgressHandler&);
+
+    void flush()
+    {
+        size_t sent = 0;
+        while (sent < pending_ && socket_ >= 0) {
+            int result = ::sendmmsg(socket_, &messages_[sent],
+                                    pending_ - sent, 0);
+            ++syscalls_;
+            if (result > 0) {
+                sent += result;
+                packets_ += result;
+            }
+            else if (errno != EINTR) {
+                // datagrams are best effort, drop the failing one
+                ++errors_;
+                ++sent;
+            }
+        }
+        pending_ = 0;
+    }
+
+    void closeSocket()
+    {
+        if (socket_ >= 0) {
+            ::close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    const MulticastConfig     config_;
+    const Encoder             encoder_;
+    int                       socket_;
+    struct sockaddr_in        destination_;
+
+    std::vector<char>         buffers_;
+    std::vector<struct iovec> iovecs_;
+    std::vector<mmsghdr>      messages_;
+    size_t                    pending_;
+
+    int64_t                   packets_;
+    int64_t                   syscalls_;
+    int64_t                   errors_;
+};
+
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef DISRUPTOR_REPLAY_H_
+#define DISRUPTOR_REPLAY_H_
+
+#include <limits>
+
+#include <disruptor/ring_buffer.h>
+#include <disruptor/crc32c.h>
+
+namespace disruptor {
+
+const size_t DEFAULT_REPLAY_WINDOW = 16;
+
+// A contiguous run of recorded events, e.g. a memory mapped journal segment
+// of fixed-layout records. Segments are replayed in the order given.
+//
+// @param <T> event type.
+template <typename T>
+struct ReplaySegment
+{
+    ReplaySegment(const T* events, size_t count)
+        : events_(events)
+        , count_(count)
+        , checksum_(0)
+        , verify_(false)
+    {
+    }
+
+    // A segment whose bytes must match the given {@link crc32c} checksum,
+    // as computed by the writer when the batch was recorded.
+    ReplaySegment(const T* events, size_t count, uint32_t checksum)
+        : events_(events)
+        , count_(count)
+        , checksum_(checksum)
+        , verify_(true)
+    {
+    }
+
+    bool valid() const
+    {
+        return !verify_ || crc32c(events_, count_ * sizeof(T)) == checksum_;
+    }
+
+    const T* events_;
+    size_t   count_;
+    uint32_t checksum_;
+    bool     verify_;
+};
+
+// Replays recorded segments into a set of shard rings on many threads.
+//
+// Reader threads grab segments in turn and split each of them into one run
+// per shard, routing every event by key. One publisher thread per shard then
+// copies its runs into the shard ring segment after segment. Events of a key
+// always land in the same shard and are published in recorded order, while
+// the reading and routing of segments scales with the number of readers.
+//
+// Readers verify the checksum of a segment before routing it, so checksums
+// are verified in parallel and nothing is published from a corrupted
+// segment: replay stops right before the first corrupted one.
+//
+// Readers stay at most window segments ahead of the slowest shard, so the
+// runs are routed into window sets of buffers reused from one segment to the
+// next, which keeps allocations off the replay once they have grown to the
+// size of the segments. Each shard ring must be claimed
+// with a single threaded strategy or better, its only publisher being the
+// shard thread.
+//
+// @param <T> event type stored in the shard rings, must be assignable.
+template <typename T>
+class ShardedReplayer
+{
+public:
+    typedef stdext::function<uint64_t (const T&)> KeyFunction;
+
+    // @param shards rings to replay into, indexed by key modulo their number.
+    // @param key of an event, events of a key keep their order.
+    // @param num_readers number of threads reading segments.
+    // @param window segments read ahead of the slowest shard.
+    ShardedReplayer(const std::vector<RingBuffer<T>*>& shards,
+                    const KeyFunction& key,
+                    int num_readers,
+                    size_t window = DEFAULT_REPLAY_WINDOW)
+        : shards_(shards)
+        , key_(key)
+        , num_readers_(num_readers)
+        , window_(window)
+        , segments_(NULL)
+        , next_segment_(0)
+        , corrupted_(std::numeric_limits<int64_t>::max())
+        , published_(new Sequence[shards.size()])
+        , replayed_(new Sequence[shards.size()])
+    {
+        assert(window_ >= 1);
+    }
+
+    // Replay all the segments and return once every event is published.
+    //
+    // @param segments to replay, in recorded order.
+    // @return number of events published.
+    int64_t replay(const std::vector< ReplaySegment<T> >& segments)
+    {
+        segments_ = &segments;
+        runs_.resize(window_);
+        for (size_t i = 0; i < runs_.size(); ++i) {
+            runs_[i].resize(shards_.size());
+            for (size_t j = 0; j < shards_.size(); ++j) {
+                runs_[i][j].clear();
+            }
+        }
+        routed_.reset(new stdext::atomic<int>[segments.size()]);
+        for (size_t i = 0; i < segments.size(); ++i) {
+            routed_[i].store(kPending);
+        }
+        next_segment_.store(0);
+        corrupted_.store(std::numeric_limits<int64_t>::max());
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            // last segment fully published by the shard
+            published_[i].set(INITIAL_CURSOR_VALUE);
+            replayed_[i].set(0);
+        }
+
+        std::vector< stdext::shared_ptr<stdext::thread> > threads;
+        for (int i = 0; i < num_readers_; ++i) {
+            threads.push_back(stdext::make_shared<stdext::thread>(
+                        stdext::bind(&ShardedReplayer::read, this)));
+        }
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            threads.push_back(stdext::make_shared<stdext::thread>(
+                        stdext::bind(&ShardedReplayer::publish, this, i)));
+        }
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i]->join();
+        }
+
+        int64_t total = 0;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            total += replayed_[i].get();
+        }
+        return total;
+    }
+
+    // Events published so far into a shard, safe to call during replay.
+    int64_t replayed(size_t shard) const
+    {
+        return replayed_[shard].get(stdext::memory_order_relaxed);
+    }
+
+    // Index of the first segment that failed verification during the last
+    // replay, -1 if none did.
+    int64_t corruptedSegment() const
+    {
+        int64_t corrupted = corrupted_.load();
+        return corrupted == std::numeric_limits<int64_t>::max()
+            ? INITIAL_CURSOR_VALUE : corrupted;
+    }
+
+    // Index of the last segment fully published into a shard, -1 if none.
+    int64_t segmentsReplayed(size_t shard) const
+    {
+        return published_[shard].get(stdext::memory_order_relaxed);
+    }
+
+private:
+    enum RoutingState {
+        kPending,
+        kRouted,
+        kCorrupted
+    };
+
+    int64_t slowestShard() const
+    {
+        int64_t minimum = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            minimum = std::min(minimum, published_[i].get());
+        }
+        return minimum;
+    }
+
+    void read()
+    {
+        const std::vector< ReplaySegment<T> >& segments = *segments_;
+        size_t index;
+        while ((index = next_segment_.fetch_add(1)) < segments.size()) {
+            // nothing past a corrupted segment gets published
+            while ((int64_t)index > slowestShard() + (int64_t)window_
+                    || (int64_t)index > corrupted_.load()) {
+                if ((int64_t)index > corrupted_.load()) {
+                    return;
+                }
+                stdext::this_thread::yield();
+            }
+
+            const ReplaySegment<T>& segment = segments[index];
+            if (!segment.valid()) {
+                int64_t corrupted = corrupted_.load();
+                while ((int64_t)index < corrupted
+                        && !corrupted_.compare_exchange_weak(corrupted, index)) {
+                }
+                routed_[index].store(kCorrupted, stdext::memory_order_release);
+                continue;
+            }
+
+            // the last segment routed into these buffers is published
+            std::vector< std::vector<const T*> >& runs = runs_[index % window_];
+            for (size_t i = 0; i < runs.size(); ++i) {
+                runs[i].reserve(segment.count_ / runs.size());
+            }
+            for (size_t i = 0; i < segment.count_; ++i) {
+                const T* event = &segment.events_[i];
+                runs[key_(*event) % shards_.size()].push_back(event);
+            }
+            routed_[index].store(kRouted, stdext::memory_order_release);
+        }
+    }
+
+    void publish(size_t shard)
+    {
+        RingBuffer<T>* ring_buffer = shards_[shard];
+        for (size_t index = 0; index < segments_->size(); ++index) {
+            int state;
+            while ((state = routed_[index].load(stdext::memory_order_acquire))
+                    == kPending) {
+                stdext::this_thread::yield();
+            }
+            if (state == kCorrupted) {
+                return;
+            }
+
+            std::vector<const T*>& run = runs_[index % window_][shard];
+            for (size_t i = 0; i < run.size(); ++i) {
+                int64_t sequence = ring_buffer->next();
+                *ring_buffer->get(sequence) = *run[i];
+                ring_buffer->publish(sequence);
+            }
+            replayed_[shard].incrementAndGet(run.size());
+            run.clear();
+            published_[shard].set(index);
+        }
+    }
+
+    const std::vector<RingBuffer<T>*>    shards_;
+    const KeyFunction                    key_;
+    const int                            num_readers_;
+    const size_t                         window_;
+
+    const std::vector< ReplaySegment<T> >* segments_;
+    // runs_[segment % window][shard], written by one reader then one shard
+    // thread
+    std::vector< std::vector< std::vector<const T*> > > runs_;
+    stdext::atomic<size_t>               next_segment_;
+    stdext::atomic<int64_t>              corrupted_;
+#ifdef has_cplusplus11
+    std::unique_ptr<stdext::atomic<int>[]> routed_;
+    std::unique_ptr<Sequence[]>          published_;
+    std::unique_ptr<Sequence[]>          replayed_;
+#else
+    boost::scoped_array< stdext::atomic<int> > routed_;
+    boost::scoped_array<Sequence>        published_;
+    boost::scoped_array<Sequence>        replayed_;
+#endif
+};
+
+}
+
+#endif
@@ -0,0 +1,352 @@
+#ifndef DISRUPTOR_REQUEST_REPLY_H_
+#define DISRUPTOR_REQUEST_REPLY_H_
+
+#include <disruptor/disruptor.h>
+
+namespace disruptor {
+
+const int DEFAULT_REPLY_SPIN_TRIES = 1000;
+
+// How a caller waits for its reply to show up in its correlation slot.
+enum ReplyWaitOption {
+    // spin then yield, lowest latency but ties up the calling thread.
+    kSpinForReply,
+    // spin then block on a condition variable, signalled by the dispatcher
+    // only while someone is parked.
+    kParkForReply
+};
+
+// Implemented by the serving side of a {@link RequestReplyChannel}.
+//
+// @param <Request> event type of the request ring.
+// @param <Reply> type of the replies.
+template <typename Request, typename Reply>
+class IRequestHandler
+{
+public:
+    virtual ~IRequestHandler() {};
+
+    // Serve a request.
+    //
+    // @param sequence of the request, used as correlation id.
+    // @param request to be served.
+    // @param reply to be filled in, a preallocated slot of the reply ring.
+    virtual void onRequest(const int64_t& sequence,
+                           Request* request,
+                           Reply* reply) = 0;
+
+    virtual void onStart() = 0;
+
+    virtual void onShutdown() = 0;
+};
+
+// Synchronous-style calls over two rings: callers publish requests to the
+// request ring, the server thread handles them and publishes replies tagged
+// with the request sequence to the reply ring, and a dispatcher thread copies
+// each reply into the correlation slot of its request.
+//
+// Correlation slots are preallocated, one per request ring entry and indexed
+// by the request sequence. Each slot has a turn counter: 2*s when free for
+// request s, 2*s + 1 once its reply is in. So a round trip takes no lock and
+// no allocation, unless callers park.
+//
+// Every ticket returned by send must be passed to receive exactly once: the
+// slot is only released for the next lap by the receiving caller. A ticket
+// never received holds up the replies behind it, and eventually the callers,
+// until the channel is stopped.
+//
+// @param <Request> event type of the request ring.
+// @param <Reply> type of the replies, must be assignable.
+template <typename Request, typename Reply>
+class RequestReplyChannel
+{
+public:
+    // will start after construct
+    RequestReplyChannel(int64_t size,
+                        ClaimStrategyOption claimStrategy,
+                        WaitStrategyOption waitStrategy,
+                        ReplyWaitOption replyWait,
+                        IRequestHandler<Request, Reply>* handler,
+                        const TimeConfig& timeConfig = TimeConfig())
+        : request_ring_(size, claimStrategy, waitStrategy, timeConfig)
+        , reply_ring_(size, kSingleThreadedStrategy, waitStrategy, timeConfig)
+        , slots_(new Slot[request_ring_.capacity()])
+        , mask_(request_ring_.capacity() - 1)
+        , reply_wait_(replyWait)
+        , parked_(0)
+        , server_(&reply_ring_, handler)
+        , dispatcher_(this)
+        , server_processor_(&request_ring_,
+                            request_ring_.newBarrier(DependentSequences()),
+                            &server_, NULL,
+                            getTimeConfig(timeConfig, kMaxIdle,
+                                          stdext::chrono::microseconds(
+                                              DEFAULT_MAX_IDLE_TIME_US)))
+        , dispatcher_processor_(&reply_ring_,
+                                reply_ring_.newBarrier(DependentSequences()),
+                                &dispatcher_, NULL,
+                                getTimeConfig(timeConfig, kMaxIdle,
+                                              stdext::chrono::microseconds(
+                                                  DEFAULT_MAX_IDLE_TIME_US)))
+        , sending_(0)
+        , closed_(false)
+        , stopped_(false)
+    {
+        for (int64_t i = 0; i <= mask_; ++i) {
+            slots_[i].turn_.store(2 * i);
+        }
+        request_ring_.setGatingSequences(
+                DependentSequences(1, server_processor_.getSequence()));
+        reply_ring_.setGatingSequences(
+                DependentSequences(1, dispatcher_processor_.getSequence()));
+
+        stdext::thread server_thread(
+                stdext::ref< BatchEventProcessor<Request> >(server_processor_));
+        server_thread_.swap(server_thread);
+        stdext::thread dispatcher_thread(
+                stdext::ref< BatchEventProcessor<ReplyEvent> >(dispatcher_processor_));
+        dispatcher_thread_.swap(dispatcher_thread);
+    }
+
+    virtual ~RequestReplyChannel()
+    {
+        if (!stopped_.load()) {
+            this->stop();
+        }
+    }
+
+    // Publish a request.
+    //
+    // @param translator fills the request.
+    // @return ticket to collect the reply with.
+    //
+    // @throws std::runtime_error once the channel is stopping.
+    int64_t send(IEventTranslator<Request>* translator)
+    {
+        // pairs with stop(): either it waits for this claim, or the claim
+        // sees the channel closed
+        sending_.fetch_add(1, stdext::memory_order_seq_cst);
+        if (closed_.load(stdext::memory_order_seq_cst)) {
+            sending_.fetch_sub(1, stdext::memory_order_release);
+            throw std::runtime_error("Channel stopped");
+        }
+        int64_t sequence;
+        try {
+            sequence = request_ring_.next();
+            translator->translateTo(sequence, request_ring_.get(sequence));
+            request_ring_.publish(sequence);
+        }
+        catch(...) {
+            sending_.fetch_sub(1, stdext::memory_order_release);
+            throw;
+        }
+        sending_.fetch_sub(1, stdext::memory_order_release);
+        return sequence;
+    }
+
+    // Wait for the reply of a request and release its slot.
+    //
+    // @param ticket returned by send.
+    // @param reply receives the reply.
+    //
+    // @throws std::runtime_error if the channel is stopped before the reply
+    // comes in.
+    void receive(const int64_t& ticket, Reply& reply)
+    {
+        Slot& slot = slots_[ticket & mask_];
+        const int64_t ready = 2 * ticket + 1;
+
+        int counter = DEFAULT_REPLY_SPIN_TRIES;
+        while (slot.turn_.load(stdext::memory_order_acquire) != ready) {
+            if (stopped_.load(stdext::memory_order_acquire)) {
+                // the last replies are dispatched before stopped is set
+                if (slot.turn_.load(stdext::memory_order_acquire) == ready) {
+                    break;
+                }
+                throw std::runtime_error("Channel stopped");
+            }
+            if (counter > 0) {
+                --counter;
+            }
+            else if (reply_wait_ == kParkForReply) {
+                park(slot, ready);
+            }
+            else {
+                stdext::this_thread::yield();
+            }
+        }
+
+        reply = slot.reply_;
+        slot.turn_.store(2 * (ticket + mask_ + 1), stdext::memory_order_release);
+    }
+
+    // Send a request and wait for its reply.
+    Reply call(IEventTranslator<Request>* translator)
+    {
+        Reply reply;
+        receive(send(translator), reply);
+        return reply;
+    }
+
+    // Stop taking requests and serve those already sent, for the server only
+    // halts once it runs out of them. Replies held up by a ticket nobody
+    // received are dropped. Callers still waiting for a reply afterwards are
+    // released.
+    void stop()
+    {
+        closed_.store(true, stdext::memory_order_seq_cst);
+        // the server keeps draining the request ring for the callers blocked
+        // in their claim, so that they all get their request in
+        while (sending_.load(stdext::memory_order_seq_cst) > 0) {
+            stdext::this_thread::yield();
+        }
+        server_processor_.halt();
+        server_thread_.join();
+        dispatcher_processor_.halt();
+        dispatcher_thread_.join();
+
+        stopped_.store(true, stdext::memory_order_seq_cst);
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        reply_ready_.notify_all();
+    }
+
+private:
+    struct ReplyEvent
+    {
+        int64_t correlation_;
+        Reply   reply_;
+    };
+
+    struct Slot
+    {
+        stdext::atomic<int64_t> turn_;
+        Reply                   reply_;
+    };
+
+    // Serves requests into the reply ring, on the server thread.
+    class ServerHandler : public IEventHandler<Request>
+    {
+    public:
+        ServerHandler(RingBuffer<ReplyEvent>* reply_ring,
+                      IRequestHandler<Request, Reply>* handler)
+            : reply_ring_(reply_ring)
+            , handler_(handler)
+        {
+        }
+
+        virtual void onEvent(const int64_t& sequence,
+                             const int64_t& batch_size,
+                             const bool& end_of_batch,
+                             Request* event)
+        {
+            if (event == NULL) {
+                return;
+            }
+
+            int64_t reply_sequence = reply_ring_->next();
+            ReplyEvent* reply = reply_ring_->get(reply_sequence);
+            reply->correlation_ = sequence;
+            handler_->onRequest(sequence, event, &reply->reply_);
+            reply_ring_->publish(reply_sequence);
+        }
+
+        virtual void onStart() { handler_->onStart(); }
+
+        virtual void onShutdown() { handler_->onShutdown(); }
+
+    private:
+        RingBuffer<ReplyEvent>*          reply_ring_;
+        IRequestHandler<Request, Reply>* handler_;
+    };
+
+    // Copies replies into their correlation slot, on the dispatcher thread.
+    class DispatchHandler : public IEventHandler<ReplyEvent>
+    {
+    public:
+        explicit DispatchHandler(RequestReplyChannel* channel)
+            : channel_(channel)
+        {
+        }
+
+        virtual void onEvent(const int64_t& sequence,
+                             const int64_t& batch_size,
+                             const bool& end_of_batch,
+                             ReplyEvent* event)
+        {
+            if (event != NULL) {
+                channel_->dispatch(*event);
+            }
+        }
+
+        virtual void onStart() {}
+
+        virtual void onShutdown() {}
+
+    private:
+        RequestReplyChannel* channel_;
+    };
+
+    void dispatch(const ReplyEvent& event)
+    {
+        Slot& slot = slots_[event.correlation_ & mask_];
+        const int64_t free_turn = 2 * event.correlation_;
+
+        // previous lap of the slot not received yet
+        while (slot.turn_.load(stdext::memory_order_acquire) != free_turn) {
+            if (closed_.load(stdext::memory_order_acquire)) {
+                // it may never be, drop the reply so that the server drains
+                // the request ring, its caller is released by stop
+                return;
+            }
+            stdext::this_thread::yield();
+        }
+
+        slot.reply_ = event.reply_;
+        slot.turn_.store(free_turn + 1, stdext::memory_order_seq_cst);
+
+        if (parked_.load(stdext::memory_order_seq_cst) > 0) {
+            stdext::unique_lock<stdext::mutex> ulock(mutex_);
+            reply_ready_.notify_all();
+        }
+    }
+
+    void park(Slot& slot, const int64_t& ready)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        parked_.fetch_add(1, stdext::memory_order_seq_cst);
+        while (slot.turn_.load(stdext::memory_order_seq_cst) != ready
+                && !stopped_.load(stdext::memory_order_seq_cst)) {
+            reply_ready_.wait(ulock);
+        }
+        parked_.fetch_sub(1, stdext::memory_order_relaxed);
+    }
+
+    RingBuffer<Request>             request_ring_;
+    RingBuffer<ReplyEvent>          reply_ring_;
+#ifdef has_cplusplus11
+    std::unique_ptr<Slot[]>         slots_;
+#else
+    boost::scoped_array<Slot>       slots_;
+#endif
+    const int64_t                   mask_;
+
+    const ReplyWaitOption           reply_wait_;
+    stdext::atomic<int>             parked_;
+    stdext::mutex                   mutex_;
+    stdext::condition_variable      reply_ready_;
+
+    ServerHandler                   server_;
+    DispatchHandler                 dispatcher_;
+    BatchEventProcessor<Request>    server_processor_;
+    BatchEventProcessor<ReplyEvent> dispatcher_processor_;
+    stdext::thread                  server_thread_;
+    stdext::thread                  dispatcher_thread_;
+    // callers in send, between the closed check and the publish
+    stdext::atomic<int>             sending_;
+    stdext::atomic<bool>            closed_;
+    stdext::atomic<bool>            stopped_;
+};
+
+}
+
+#endif
@@ -18,14 +18,14 @@ public:
     // Construct a RingBuffer with the full option set.
     //
     // @param event_factory to instance new entries for filling the RingBuffer.
-    // @param buffer_size of the RingBuffer, must be a power of 2.
+    // @param buffer_size of the RingBuffer, rounded up to a power of 2.
     // @param claim_strategy_option threading strategy for publishers claiming
     // entries in the ring.
     // @param wait_strategy_option waiting strategy employed by
     // processors_to_track waiting in entries becoming available.
     //
     RingBuffer(IEventFactory<T>* event_factory,
-               int buffer_size,
+               int64_t buffer_size,
                ClaimStrategyOption claim_strategy_option,
                WaitStrategyOption wait_strategy_option,
                const TimeConfig& timeConfig = TimeConfig())
@@ -33,15 +33,15 @@ public:
                     claim_strategy_option,
                     wait_strategy_option,
                     timeConfig)
-        , mask_(buffer_size - 1)
-        , events_(new T[buffer_size])
+        , mask_(capacity() - 1)
+        , events_(new T[capacity()])
     {
         if (event_factory) {
             this->fill(event_factory);
         }
     }
 
-    RingBuffer(int buffer_size,
+    RingBuffer(int64_t buffer_size,
                ClaimStrategyOption claim_strategy_option,
                WaitStrategyOption wait_strategy_option,
                const TimeConfig& timeConfig) 
@@ -49,8 +49,8 @@ public:
                     claim_strategy_option,
                     wait_strategy_option,
                     timeConfig)
-        , mask_(buffer_size - 1)
-        , events_(new T[buffer_size])
+        , mask_(capacity() - 1)
+        , events_(new T[capacity()])
     {
     }
 
@@ -67,16 +67,56 @@ public:
         return &events_[sequence & mask_];
     }
 
+    // Hint the CPU to start loading every cache line of the event for a given
+    // sequence, so a consumer about to read it does not stall on the miss.
+    //
+    // @param sequence for the event
+    void prefetch(const int64_t& sequence) const
+    {
+        prefetchLines<0>(sequence);
+    }
+
+    // Same as {@link prefetch} but for a publisher about to write the event:
+    // lines are requested in exclusive state (prefetchw where available), so
+    // the stores do not wait for the ownership of the lines.
+    //
+    // @param sequence for the event
+    void prefetchForWrite(const int64_t& sequence) const
+    {
+        prefetchLines<1>(sequence);
+    }
+
+    // Pre-fault the pages backing the events, see {@link prefaultMemory}.
+    //
+    // @param lock_memory also lock the events into RAM.
+    // @return false if locking was requested and failed.
+    bool preFault(bool lock_memory = false)
+    {
+        return prefaultMemory(&events_[0], capacity() * sizeof(T), lock_memory);
+    }
+
 private:
+    template <int ForWrite>
+    void prefetchLines(const int64_t& sequence) const
+    {
+        const char* event = reinterpret_cast<const char*>(&events_[sequence & mask_]);
+        for (size_t offset = 0; offset < sizeof(T);
+                offset += CACHE_LINE_SIZE_IN_BYTES) {
+            __builtin_prefetch(event + offset, ForWrite, 3);
+        }
+        // the event may straddle one more line than its size suggests
+        __builtin_prefetch(event + sizeof(T) - 1, ForWrite, 3);
+    }
+
     void fill( IEventFactory<T>* factory)
     {
-        for (int i = 0; i < capacity(); ++i) {
+        for (int64_t i = 0; i < capacity(); ++i) {
             events_[i] = *(factory->newInstance());
         }
     }
 
 private:
-    int mask_;
+    int64_t mask_;
 #ifdef has_cplusplus11
     std::unique_ptr<T[]> events_;
 #else
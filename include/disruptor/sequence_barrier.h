@@ -6,13 +6,14 @@
 
 #include <disruptor/exceptions.h>
 #include <disruptor/interface.h>
+#include <disruptor/wait_strategy.h>
 
 namespace disruptor {
 
 class ProcessingSequenceBarrier : public ISequenceBarrier
 {
     public:
-        ProcessingSequenceBarrier(IWaitStrategy* wait_strategy,
+        ProcessingSequenceBarrier(const WaitStrategyPtr& wait_strategy,
                 Sequence* sequence,
                 const DependentSequences& dependent_sequences)
             : wait_strategy_(wait_strategy)
@@ -20,14 +21,21 @@ class ProcessingSequenceBarrier : public ISequenceBarrier
             , dependent_sequences_(dependent_sequences)
             , alerted_(false)
         {
+            subscribe();
         }
 
-        ProcessingSequenceBarrier(IWaitStrategy* wait_strategy,
+        ProcessingSequenceBarrier(const WaitStrategyPtr& wait_strategy,
                 Sequence* sequence)
             : wait_strategy_(wait_strategy)
             , cursor_sequence_(sequence)
             , alerted_(false)
         {
+            subscribe();
+        }
+
+        virtual ~ProcessingSequenceBarrier()
+        {
+            wait_strategy_->removeWaitQueue(&wait_queue_);
         }
 
         virtual int64_t waitFor(const int64_t& sequence)
@@ -43,11 +51,34 @@ class ProcessingSequenceBarrier : public ISequenceBarrier
                     *cursor_sequence_, dependent_sequences_, *this, timeout);
         }
 
+        virtual int64_t waitFor(const int64_t& sequence,
+                                const ISequenceBarrier& alerts)
+        {
+            return wait_strategy_->waitFor(sequence,
+                    *cursor_sequence_, dependent_sequences_, alerts);
+        }
+
+        virtual int64_t waitFor(const int64_t& sequence,
+                                const stdext::chrono::microseconds& timeout,
+                                const ISequenceBarrier& alerts)
+        {
+            return wait_strategy_->waitFor(sequence,
+                    *cursor_sequence_, dependent_sequences_, alerts, timeout);
+        }
+
         virtual int64_t getCursor() const
         {
             return cursor_sequence_->get();
         }
 
+        virtual int64_t getAvailableSequence() const
+        {
+            if (dependent_sequences_.empty()) {
+                return cursor_sequence_->get();
+            }
+            return getMinimumSequence(dependent_sequences_);
+        }
+
         virtual bool isAlerted() const
         {
             return alerted_.load(stdext::memory_order_acquire);
@@ -56,6 +87,7 @@ class ProcessingSequenceBarrier : public ISequenceBarrier
         virtual void alert()
         {
             alerted_.store(true, stdext::memory_order_release);
+            wait_queue_.notify();
         }
 
         virtual void clearAlert()
@@ -70,11 +102,139 @@ class ProcessingSequenceBarrier : public ISequenceBarrier
             }
         }
 
+        virtual WaitQueue* getWaitQueue() const
+        {
+            return &wait_queue_;
+        }
+
     private:
-        IWaitStrategy*       wait_strategy_;
+        // Get signalled by the sequences that gate this barrier: the
+        // dependents if any, they are never ahead of the cursor.
+        void subscribe()
+        {
+            if (dependent_sequences_.empty()) {
+                wait_strategy_->addWaitQueue(&wait_queue_,
+                        DependentSequences(1, cursor_sequence_));
+            }
+            else {
+                wait_strategy_->addWaitQueue(&wait_queue_,
+                        dependent_sequences_);
+            }
+        }
+
+
+        // shared with the sequencer, the barrier may outlive it and still
+        // has to unsubscribe its queue
+        WaitStrategyPtr      wait_strategy_;
         Sequence*            cursor_sequence_;
         DependentSequences   dependent_sequences_;
         stdext::atomic<bool> alerted_;
+        mutable WaitQueue    wait_queue_;
+};
+
+// The view one {@link EventProcessor} has of a barrier it may share with
+// others: waiting on it is aborted by an alert of the shared barrier, as for
+// everybody, or by an interrupt of this view only. Processors use interrupts
+// to get their own thread out of a wait without disturbing the other
+// processors on the barrier.
+class InterruptibleSequenceBarrier : public ISequenceBarrier
+{
+    public:
+        explicit InterruptibleSequenceBarrier(const SequenceBarrierPtr& barrier)
+            : barrier_(barrier)
+            , interrupted_(false)
+        {
+        }
+
+        virtual int64_t waitFor(const int64_t& sequence)
+        {
+            return barrier_->waitFor(sequence, *this);
+        }
+
+        virtual int64_t waitFor(const int64_t& sequence,
+                                const stdext::chrono::microseconds& timeout)
+        {
+            return barrier_->waitFor(sequence, timeout, *this);
+        }
+
+        virtual int64_t waitFor(const int64_t& sequence,
+                                const ISequenceBarrier& alerts)
+        {
+            return barrier_->waitFor(sequence, alerts);
+        }
+
+        virtual int64_t waitFor(const int64_t& sequence,
+                                const stdext::chrono::microseconds& timeout,
+                                const ISequenceBarrier& alerts)
+        {
+            return barrier_->waitFor(sequence, timeout, alerts);
+        }
+
+        virtual int64_t getCursor() const
+        {
+            return barrier_->getCursor();
+        }
+
+        virtual int64_t getAvailableSequence() const
+        {
+            return barrier_->getAvailableSequence();
+        }
+
+        virtual bool isAlerted() const
+        {
+            return interrupted_.load(stdext::memory_order_acquire)
+                || barrier_->isAlerted();
+        }
+
+        // Alert the shared barrier, see {@link ISequenceBarrier#alert}.
+        virtual void alert()
+        {
+            barrier_->alert();
+        }
+
+        virtual void clearAlert()
+        {
+            barrier_->clearAlert();
+        }
+
+        virtual void checkAlert() const
+        {
+            if (isAlerted()) {
+                throw AlertException();
+            }
+        }
+
+        virtual WaitQueue* getWaitQueue() const
+        {
+            return barrier_->getWaitQueue();
+        }
+
+        // Abort the wait of the thread waiting on this view, or its next one,
+        // with an AlertException, until cleared.
+        void interrupt()
+        {
+            interrupted_.store(true, stdext::memory_order_release);
+            WaitQueue* queue = barrier_->getWaitQueue();
+            if (queue) {
+                // the others parked on the queue go back to sleep
+                queue->notify();
+            }
+        }
+
+        void clearInterrupt()
+        {
+            interrupted_.store(false, stdext::memory_order_release);
+        }
+
+        // Whether the shared barrier is alerted, interrupts aside.
+        bool isSharedAlerted() const
+        {
+            return barrier_->isAlerted();
+        }
+
+    private:
+        SequenceBarrierPtr   barrier_;
+        stdext::atomic<bool> interrupted_;
 };
 
 }
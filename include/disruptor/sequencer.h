@@ -18,7 +18,7 @@ public:
     // @param buffer_size over which sequences are valid.
     // @param claim_strategy_option for those claiming sequences.
     // @param wait_strategy_option for those waiting on sequences.
-    Sequencer(int buffer_size,
+    Sequencer(int64_t buffer_size,
               ClaimStrategyOption claim_strategy_option,
               WaitStrategyOption wait_strategy_option,
               const TimeConfig& timeConfig=TimeConfig())
@@ -49,13 +49,18 @@ public:
     SequenceBarrierPtr newBarrier(const DependentSequences& sequences_to_track)
     {
         return stdext::make_shared<ProcessingSequenceBarrier>(
-                wait_strategy_.get(), &cursor_, sequences_to_track );
+                wait_strategy_, &cursor_, sequences_to_track );
     }
 
+    // The strategy processors wait with, e.g. to read its statistics.
+    //
+    // @return wait strategy of the sequencer.
+    IWaitStrategy* getWaitStrategy() const { return wait_strategy_.get(); }
+
     // The capacity of the data structure to hold entries.
     //
     // @return capacity of the data structure.
-    int capacity() const { return buffer_size_; }
+    int64_t capacity() const { return buffer_size_; }
 
 
     // Get the value of the cursor indicating the published sequence.
@@ -76,7 +81,7 @@ public:
     // Get the remaining capacity for this sequencer.
     //
     // @return The number of slots remaining.
-    int remainingCapacity() const
+    int64_t remainingCapacity() const
     {
         return this->capacity() - this->occupiedCapacity();
     }
@@ -84,11 +89,11 @@ public:
     // Get the slots taken for this sequencer.
     //
     // @return The number of slots taken.
-    int occupiedCapacity() const
+    int64_t occupiedCapacity() const
     {
         int64_t consumed = getMinimumSequence(gating_sequences_);
         int64_t produced = cursor_.get();
-        return static_cast<int>((buffer_size_ + produced - consumed) % buffer_size_);
+        return (buffer_size_ + produced - consumed) % buffer_size_;
     }
 
     // Claim the next event in sequence for publishing to the {@link RingBuffer}.
@@ -128,16 +133,38 @@ public:
     void forcePublish(const int64_t& sequence)
     {
         cursor_.set(sequence);
-        wait_strategy_->signalAllWhenBlocking();
+        wait_strategy_->signalWhenBlocking(cursor_);
+    }
+
+    // Wake the {@link EventProcessor}s blocked on the progress of another
+    // one, to be called by the latter after advancing its sequence.
+    //
+    // @param sequence of the processor that has advanced.
+    void signal(const Sequence& sequence)
+    {
+        wait_strategy_->signalWhenBlocking(sequence);
+    }
+
+    // Rewind the cursor and the claim strategy to the given sequence.
+    //
+    // Only use this method when no publisher is claiming and every gating
+    // {@link EventProcessor} is halted, their sequences must be rewound by
+    // their owners.
+    //
+    // @param sequence to which the cursor is rewound.
+    void reset(const int64_t& sequence = INITIAL_CURSOR_VALUE)
+    {
+        claim_strategy_->reset(sequence);
+        cursor_.set(sequence);
     }
 
 protected:
-    const int buffer_size_;
+    const int64_t buffer_size_;
 
     void publish(const int64_t& sequence, const int64_t& batch_size)
     {
         claim_strategy_->serialisePublishing(sequence, cursor_, batch_size);
-        wait_strategy_->signalAllWhenBlocking();
+        wait_strategy_->signalWhenBlocking(cursor_);
     }
 
     Sequence cursor_;
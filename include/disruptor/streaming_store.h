@@ -0,0 +1,105 @@
+#ifndef DISRUPTOR_STREAMING_STORE_H_
+#define DISRUPTOR_STREAMING_STORE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <disruptor/interface.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DISRUPTOR_HAS_STREAMING_STORES
+#endif
+
+namespace disruptor {
+
+// Copies below this size stay in the cache, the consumer is likely to read
+// them before they are evicted anyway.
+const size_t DEFAULT_STREAMING_THRESHOLD = 1024;
+
+// Copy a buffer with non-temporal stores, which write whole lines to memory
+// without reading them first nor keeping them in the cache of the writer.
+// For large events this saves the read for ownership of every line, and
+// leaves the lines to be fetched by the consumer from memory or the shared
+// cache rather than from the core of the publisher.
+//
+// Falls back to memcpy below the threshold or without SSE2. Non-temporal
+// stores are not ordered with the other stores, so the copy ends with a
+// store fence: the data is visible before the event is published.
+//
+// @param destination of the copy.
+// @param source of the copy.
+// @param length in bytes.
+// @param threshold below which memcpy is used.
+inline void streamingCopy(void* destination,
+                          const void* source,
+                          size_t length,
+                          size_t threshold = DEFAULT_STREAMING_THRESHOLD)
+{
+#ifdef DISRUPTOR_HAS_STREAMING_STORES
+    char* to = static_cast<char*>(destination);
+    const char* from = static_cast<const char*>(source);
+    if (length < threshold || length < 128) {
+        memcpy(to, from, length);
+        return;
+    }
+
+    // regular stores up to the first 16 bytes boundary
+    size_t head = (16 - (reinterpret_cast<uintptr_t>(to) & 15)) & 15;
+    memcpy(to, from, head);
+    to += head;
+    from += head;
+    length -= head;
+
+    for ( ; length >= 64; length -= 64, to += 64, from += 64) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(to), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(to + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(to + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(to + 48), d);
+    }
+    for ( ; length >= 16; length -= 16, to += 16, from += 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(to),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(from)));
+    }
+    memcpy(to, from, length);
+    _mm_sfence();
+#else
+    memcpy(destination, source, length);
+#endif
+}
+
+// Translator copying a whole event from a source with {@link streamingCopy}.
+// Point it at the next source before each publish.
+//
+// @param <T> trivially copyable event type.
+template <typename T>
+class StreamingCopyTranslator : public IEventTranslator<T>
+{
+public:
+    explicit StreamingCopyTranslator(
+            size_t threshold = DEFAULT_STREAMING_THRESHOLD)
+        : source_(NULL)
+        , threshold_(threshold)
+    {
+    }
+
+    void setSource(const T* source) { source_ = source; }
+
+    virtual T* translateTo(const int64_t& sequence, T* event)
+    {
+        streamingCopy(event, source_, sizeof(T), threshold_);
+        return event;
+    }
+
+private:
+    const T* source_;
+    size_t   threshold_;
+};
+
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define DISRUPTOR_UTILS_H_
 
 #include <climits>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <vector>
 #include <map>
 #include <memory>
@@ -31,7 +33,11 @@ namespace disruptor {
 
 enum TimeConfigKey {
     kSleep,
-    kMaxIdle
+    kMaxIdle,
+    // longest step of a progressive sleep.
+    kMaxSleep,
+    // timer slack requested for the sleeping threads.
+    kTimerSlack
 };
 
 typedef std::map<TimeConfigKey, stdext::chrono::microseconds> TimeConfig;
@@ -64,6 +70,33 @@ inline size_t ceilToPow2(size_t x)
     return x;
 }
 
+// Touch every page of the given range for write, so the kernel backs it with
+// real frames now rather than on the first publish, and optionally lock the
+// range into RAM. The content of the memory is left untouched.
+//
+// @param address start of the range.
+// @param length of the range in bytes.
+// @param lock_memory also mlock(2) the range.
+// @return false if locking was requested and failed.
+inline bool prefaultMemory(void* address, size_t length, bool lock_memory)
+{
+    if (length == 0) {
+        return true;
+    }
+
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    volatile char* bytes = static_cast<volatile char*>(address);
+    for (size_t offset = 0; offset < length; offset += page_size) {
+        bytes[offset] = bytes[offset];
+    }
+    bytes[length - 1] = bytes[length - 1];
+
+    if (lock_memory) {
+        return ::mlock(address, length) == 0;
+    }
+    return true;
+}
+
 }
 
 #endif
@@ -1,8 +1,18 @@
 #ifndef DISRUPTOR_WAIT_STRATEGY_H_
 #define DISRUPTOR_WAIT_STRATEGY_H_
 
+#include <errno.h>
+#include <time.h>
+#include <sys/prctl.h>
 #include <sys/time.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <disruptor/exceptions.h>
 #include <disruptor/interface.h>
 
@@ -24,17 +34,67 @@ enum WaitStrategyOption {
     kYieldingStrategy,
     // This strategy call spins in a loop as a waiting strategy which is
     // lowest and most consistent latency but ties up a CPU.
-    kBusySpinStrategy
+    kBusySpinStrategy,
+    // This strategy spins, then sleeps until absolute deadlines on the
+    // monotonic clock with a reduced timer slack, in steps growing from
+    // kSleep to kMaxSleep (kSleep by default). For low CPU consumers that
+    // still need to react within tens of microseconds.
+    kPreciseSleepingStrategy,
+    // This strategy switches at runtime between candidate strategies, see
+    // {@link TunableWaitStrategy}. It waits like the first candidate until a
+    // {@link WaitStrategyTuner} picks one.
+    kTunableStrategy
+};
+
+// Threads waiting on one {@link SequenceBarrier}, parked until a sequence the
+// barrier depends on advances.
+class WaitQueue
+{
+public:
+    WaitQueue() {}
+
+    void notify()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        condition_.notify_all();
+    }
+
+    stdext::mutex              mutex_;
+    stdext::condition_variable condition_;
+
+private:
+    WaitQueue(const WaitQueue&);
+    WaitQueue& operator= (const WaitQueue&);
 };
 
 // Blocking strategy that uses a lock and condition variable for
 // {@link Consumer}s waiting on a barrier.
 // This strategy should be used when performance and low-latency are not as
 // important as CPU resource.
+//
+// Each barrier has its own {@link WaitQueue}, signalled only when one of the
+// sequences it depends on advances: the cursor for the first stage, upstream
+// processors for the others. So a publish only wakes the first stage, and
+// dependent stages sleep until their upstream processors move rather than
+// spinning on them. Signalling costs a fence and a load while nobody waits.
+//
+// The queues are listed per sequence when barriers subscribe, in a table
+// replaced on each subscription change, so that a signal only looks up the
+// sequence that moved, without taking a lock.
 class BlockingStrategy : public IWaitStrategy
 {
 public:
-    BlockingStrategy() {}
+    BlockingStrategy()
+        : parked_(0)
+        , subscriptions_(new Subscriptions())
+        , signalling_(0)
+    {
+    }
+
+    ~BlockingStrategy()
+    {
+        delete subscriptions_.load();
+    }
 
     virtual int64_t waitFor(const int64_t& sequence,
                             const Sequence& cursor,
@@ -43,21 +103,14 @@ public:
     {
         int64_t available_sequence = 0;
         // We need to wait.
-        if ((available_sequence = cursor.get()) < sequence) {
-            // acquire lock
-            stdext::unique_lock<stdext::recursive_mutex> ulock(mutex_);
-            while ((available_sequence = cursor.get()) < sequence) {
-                barrier.checkAlert();
-                consumer_notify_condition_.wait(ulock);
-            }
-        } // unlock happens here, on ulock destruction.
-
-        if (0 != dependents.size()) {
+        if ((available_sequence = available(cursor, dependents)) < sequence) {
+            Parking parking(barrier, parked_);
             while ((available_sequence
-                        = getMinimumSequence(dependents)) < sequence) {
+                        = available(cursor, dependents)) < sequence) {
                 barrier.checkAlert();
+                parking.wait();
             }
-        }
+        } // unlock happens here, on parking destruction.
 
         return available_sequence;
     }
@@ -70,35 +123,220 @@ public:
     {
         int64_t available_sequence = 0;
         // We have to wait
-        if ((available_sequence = cursor.get()) < sequence) {
-            stdext::unique_lock<stdext::recursive_mutex> ulock(mutex_);
-            while ((available_sequence = cursor.get()) < sequence) {
+        if ((available_sequence = available(cursor, dependents)) < sequence) {
+            // wake ups for other reasons must not extend the wait
+            const stdext::chrono::steady_clock::time_point deadline =
+                stdext::chrono::steady_clock::now() + timeout;
+            Parking parking(barrier, parked_);
+            while ((available_sequence
+                        = available(cursor, dependents)) < sequence) {
                 barrier.checkAlert();
-                if (!consumer_notify_condition_.timed_wait(ulock, timeout))
+                if (!parking.waitUntil(deadline)) {
+                    available_sequence = available(cursor, dependents);
                     break;
+                }
+            }
+        } // unlock happens here, on parking destruction
+
+        return available_sequence;
+    }
 
+    virtual void signalAllWhenBlocking()
+    {
+        if (!anyParked()) {
+            return;
+        }
+        Snapshot snapshot(subscriptions_, signalling_);
+        for (size_t i = 0; i < snapshot->size(); ++i) {
+            (*snapshot)[i].notify();
+        }
+    }
+
+    virtual void signalWhenBlocking(const Sequence& sequence)
+    {
+        if (!anyParked()) {
+            return;
+        }
+        Snapshot snapshot(subscriptions_, signalling_);
+        Subscriptions::const_iterator it = std::lower_bound(
+                snapshot->begin(), snapshot->end(), &sequence, precedes);
+        if (it != snapshot->end() && it->sequence_ == &sequence) {
+            it->notify();
+        }
+    }
+
+    virtual void addWaitQueue(WaitQueue* queue,
+                              const DependentSequences& sequences)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(registry_mutex_);
+        Subscriptions* subscriptions =
+            new Subscriptions(*subscriptions_.load());
+        for (size_t i = 0; i < sequences.size(); ++i) {
+            Subscriptions::iterator it = std::lower_bound(
+                    subscriptions->begin(), subscriptions->end(),
+                    sequences[i], precedes);
+            if (it == subscriptions->end() || it->sequence_ != sequences[i]) {
+                it = subscriptions->insert(it, Subscribers(sequences[i]));
             }
-        } // unlock happens here, on ulock destruction
+            it->queues_.push_back(queue);
+        }
+        replace(subscriptions);
+    }
 
-        if (0 != dependents.size()) {
-            while ((available_sequence
-                        = getMinimumSequence(dependents)) < sequence) {
-                barrier.checkAlert();
+    virtual void removeWaitQueue(WaitQueue* queue)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(registry_mutex_);
+        Subscriptions* subscriptions =
+            new Subscriptions(*subscriptions_.load());
+        for (size_t i = subscriptions->size(); i > 0; --i) {
+            std::vector<WaitQueue*>& queues = (*subscriptions)[i - 1].queues_;
+            queues.erase(std::remove(queues.begin(), queues.end(), queue),
+                         queues.end());
+            if (queues.empty()) {
+                subscriptions->erase(subscriptions->begin() + (i - 1));
             }
         }
+        // no signal reaches the queue once this returns
+        replace(subscriptions);
+    }
 
-        return available_sequence;
+private:
+    // The queues of the barriers gated by one sequence.
+    struct Subscribers
+    {
+        explicit Subscribers(const Sequence* sequence) : sequence_(sequence) {}
+
+        void notify() const
+        {
+            for (size_t i = 0; i < queues_.size(); ++i) {
+                queues_[i]->notify();
+            }
+        }
+
+        const Sequence*         sequence_;
+        std::vector<WaitQueue*> queues_;
+    };
+
+    // Sorted by sequence address.
+    typedef std::vector<Subscribers> Subscriptions;
+
+    static bool precedes(const Subscribers& subscribers,
+                         const Sequence* sequence)
+    {
+        return std::less<const Sequence*>()(subscribers.sequence_, sequence);
     }
 
-    virtual void signalAllWhenBlocking()
+    // The current table, held for the duration of a signal.
+    class Snapshot
     {
-        stdext::unique_lock<stdext::recursive_mutex> ulock(mutex_);
-        consumer_notify_condition_.notify_all();
+    public:
+        Snapshot(const stdext::atomic<Subscriptions*>& subscriptions,
+                 stdext::atomic<int>& signalling)
+            : signalling_(signalling)
+        {
+            // pairs with replace(): either it waits for this signal to end,
+            // or the signal reads the table it put in place
+            signalling_.fetch_add(1, stdext::memory_order_seq_cst);
+            subscriptions_ = subscriptions.load(stdext::memory_order_seq_cst);
+        }
+
+        ~Snapshot()
+        {
+            signalling_.fetch_sub(1, stdext::memory_order_release);
+        }
+
+        const Subscriptions* operator->() const { return subscriptions_; }
+
+        const Subscriptions& operator*() const { return *subscriptions_; }
+
+    private:
+        stdext::atomic<int>& signalling_;
+        const Subscriptions* subscriptions_;
+    };
+
+    // Holds the lock of the queue of a barrier and counts the thread as
+    // parked for as long as it waits, exceptions included.
+    class Parking
+    {
+    public:
+        Parking(const ISequenceBarrier& barrier, stdext::atomic<int>& parked)
+            : queue_(barrier.getWaitQueue())
+            , parked_(parked)
+        {
+            if (queue_) {
+                stdext::unique_lock<stdext::mutex> ulock(queue_->mutex_);
+                ulock_.swap(ulock);
+            }
+            parked_.fetch_add(1);
+            // pairs with the fence of anyParked, either the waiter sees the
+            // new sequence or the signaller sees the waiter
+            stdext::atomic_thread_fence(stdext::memory_order_seq_cst);
+        }
+
+        ~Parking()
+        {
+            parked_.fetch_sub(1);
+        }
+
+        void wait()
+        {
+            if (queue_) {
+                queue_->condition_.wait(ulock_);
+            }
+            else {
+                stdext::this_thread::yield();
+            }
+        }
+
+        // @return false once the deadline has passed.
+        bool waitUntil(const stdext::chrono::steady_clock::time_point& deadline)
+        {
+            if (queue_) {
+                return queue_->condition_.wait_until(ulock_, deadline)
+                    == stdext::cv_status::no_timeout;
+            }
+            stdext::this_thread::yield();
+            return stdext::chrono::steady_clock::now() < deadline;
+        }
+
+    private:
+        WaitQueue*                         queue_;
+        stdext::atomic<int>&               parked_;
+        stdext::unique_lock<stdext::mutex> ulock_;
+    };
+
+    static int64_t available(const Sequence& cursor,
+                             const DependentSequences& dependents)
+    {
+        if (dependents.empty()) {
+            return cursor.get();
+        }
+        return std::min(cursor.get(), getMinimumSequence(dependents));
     }
 
-private:
-    stdext::recursive_mutex mutex_;
-    stdext::condition_variable_any consumer_notify_condition_;
+    bool anyParked() const
+    {
+        stdext::atomic_thread_fence(stdext::memory_order_seq_cst);
+        return parked_.load(stdext::memory_order_relaxed) > 0;
+    }
+
+    // Put a new table in place, and free the old one once no signal reads
+    // it any more. Subscriptions only change as barriers come and go.
+    void replace(Subscriptions* subscriptions)
+    {
+        Subscriptions* previous = subscriptions_.exchange(subscriptions,
+                stdext::memory_order_seq_cst);
+        while (signalling_.load(stdext::memory_order_seq_cst) > 0) {
+            stdext::this_thread::yield();
+        }
+        delete previous;
+    }
+
+    stdext::atomic<int>             parked_;
+    // serialises the changes of the table
+    stdext::mutex                   registry_mutex_;
+    stdext::atomic<Subscriptions*>  subscriptions_;
+    stdext::atomic<int>             signalling_;
 };
 
 // Sleeping strategy
@@ -190,7 +428,8 @@ private:
             // resolution and can not sleep on microsecond precision,
             // to sleep more accurately, consider changing to clock_nanosleep,
             // however, I see no difference on redhat 6 with tsc clock source,
-            // so I'll keep it like this for now.
+            // so I'll keep it like this for now. See PreciseSleepingStrategy
+            // for deadline based sleeps with a reduced timer slack.
             stdext::this_thread::sleep(sleep_time_);
         }
 
@@ -364,6 +603,374 @@ public:
 };
 
 
+const int64_t DEFAULT_PRECISE_SLEEP_US = 10;
+const int64_t DEFAULT_TIMER_SLACK_US = 1;
+
+inline int64_t monotonicNanos()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000 * 1000 * 1000 + now.tv_nsec;
+}
+
+// Sleep until an absolute deadline on the monotonic clock. Unlike a relative
+// sleep, the deadline does not drift when the thread is interrupted or
+// preempted before the call.
+//
+// @param deadline_ns on the CLOCK_MONOTONIC timeline.
+inline void sleepUntil(const int64_t& deadline_ns)
+{
+    struct timespec deadline;
+    deadline.tv_sec = deadline_ns / (1000 * 1000 * 1000);
+    deadline.tv_nsec = deadline_ns % (1000 * 1000 * 1000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL)
+            == EINTR) {
+    }
+}
+
+// Set the timer slack of the calling thread, the kernel defaults to 50us
+// which is added to most sleeps. Only calls into the kernel when the thread
+// asks for a slack it does not have yet.
+//
+// @param slack_ns timer slack in nanoseconds, at least 1.
+inline void setTimerSlack(const int64_t& slack_ns)
+{
+    static __thread int64_t current_slack_ns = 0;
+    if (current_slack_ns != slack_ns) {
+        prctl(PR_SET_TIMERSLACK, (unsigned long)slack_ns, 0, 0, 0);
+        current_slack_ns = slack_ns;
+    }
+}
+
+// Sleeping strategy with precise wake ups.
+//
+// Waiters spin a few times, then sleep with clock_nanosleep until absolute
+// deadlines, starting with the shortest step and doubling it after every
+// sleep up to the longest one. Each sleeping thread lowers its own timer
+// slack first, so a 10us step takes close to 10us rather than 60us.
+//
+// How late the wake ups are is measured, see {@link overshootMeanNanos} and
+// {@link overshootMaxNanos}, to help choosing the steps and the slack.
+class PreciseSleepingStrategy : public IWaitStrategy
+{
+public:
+    // @param min_sleep first sleep step.
+    // @param max_sleep longest sleep step.
+    // @param timer_slack requested for the sleeping threads.
+    PreciseSleepingStrategy(const stdext::chrono::microseconds& min_sleep,
+                            const stdext::chrono::microseconds& max_sleep,
+                            const stdext::chrono::microseconds& timer_slack)
+        : min_sleep_ns_(std::max<int64_t>(min_sleep.count(), 1) * 1000)
+        , max_sleep_ns_(std::max<int64_t>(max_sleep.count(), 1) * 1000)
+        , timer_slack_ns_(std::max<int64_t>(timer_slack.count() * 1000, 1))
+        , sleeps_(0)
+        , overshoot_total_ns_(0)
+        , overshoot_max_ns_(0)
+    {
+    }
+
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const Sequence& cursor,
+                            const DependentSequences& dependents,
+                            const ISequenceBarrier& barrier)
+    {
+        return waitUntil(sequence, cursor, dependents, barrier,
+                         std::numeric_limits<int64_t>::max());
+    }
+
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const Sequence& cursor,
+                            const DependentSequences& dependents,
+                            const ISequenceBarrier& barrier,
+                            const stdext::chrono::microseconds& timeout)
+    {
+        return waitUntil(sequence, cursor, dependents, barrier,
+                         monotonicNanos() + (int64_t)timeout.count() * 1000);
+    }
+
+    virtual void signalAllWhenBlocking() {}
+
+    // Number of sleeps taken so far.
+    int64_t sleeps() const
+    {
+        return sleeps_.load(stdext::memory_order_relaxed);
+    }
+
+    // Mean delay between the deadline of a sleep and the actual wake up.
+    int64_t overshootMeanNanos() const
+    {
+        int64_t sleeps = this->sleeps();
+        return sleeps == 0 ? 0
+            : overshoot_total_ns_.load(stdext::memory_order_relaxed) / sleeps;
+    }
+
+    // Longest delay between the deadline of a sleep and the actual wake up.
+    int64_t overshootMaxNanos() const
+    {
+        return overshoot_max_ns_.load(stdext::memory_order_relaxed);
+    }
+
+    static const int retries = 10;
+
+private:
+    static int64_t available(const Sequence& cursor,
+                             const DependentSequences& dependents)
+    {
+        return dependents.empty() ? cursor.get()
+            : getMinimumSequence(dependents);
+    }
+
+    int64_t waitUntil(const int64_t& sequence,
+                      const Sequence& cursor,
+                      const DependentSequences& dependents,
+                      const ISequenceBarrier& barrier,
+                      const int64_t& timeout_ns)
+    {
+        int64_t available_sequence = 0;
+        int counter = retries;
+        int64_t step_ns = min_sleep_ns_;
+
+        while ((available_sequence = available(cursor, dependents)) < sequence) {
+            barrier.checkAlert();
+            if (counter > 0) {
+                --counter;
+                continue;
+            }
+
+            int64_t now = monotonicNanos();
+            if (now >= timeout_ns) {
+                break;
+            }
+            sleep(std::min(now + step_ns, timeout_ns));
+            step_ns = std::min(step_ns * 2, max_sleep_ns_);
+        }
+
+        return available_sequence;
+    }
+
+    void sleep(const int64_t& deadline_ns)
+    {
+        setTimerSlack(timer_slack_ns_);
+        sleepUntil(deadline_ns);
+
+        int64_t overshoot = std::max<int64_t>(monotonicNanos() - deadline_ns, 0);
+        sleeps_.fetch_add(1, stdext::memory_order_relaxed);
+        overshoot_total_ns_.fetch_add(overshoot, stdext::memory_order_relaxed);
+        int64_t max = overshoot_max_ns_.load(stdext::memory_order_relaxed);
+        while (overshoot > max
+                && !overshoot_max_ns_.compare_exchange_weak(max, overshoot,
+                        stdext::memory_order_relaxed)) {
+        }
+    }
+
+    const int64_t           min_sleep_ns_;
+    const int64_t           max_sleep_ns_;
+    const int64_t           timer_slack_ns_;
+
+    stdext::atomic<int64_t> sleeps_;
+    stdext::atomic<int64_t> overshoot_total_ns_;
+    stdext::atomic<int64_t> overshoot_max_ns_;
+};
+
+
+// A wait strategy with its sleep period, which is all it takes to build a
+// ring waiting the same way again.
+struct WaitConfig
+{
+    explicit WaitConfig(WaitStrategyOption option = kYieldingStrategy,
+                        const stdext::chrono::microseconds& sleep =
+                            stdext::chrono::microseconds(0))
+        : option_(option)
+        , sleep_(sleep)
+    {
+    }
+
+    // Time config to pass with option_ when building a ring, on top of the
+    // given one.
+    TimeConfig timeConfig(const TimeConfig& base = TimeConfig()) const
+    {
+        TimeConfig result(base);
+        if (sleep_.count() != 0) {
+            result[kSleep] = sleep_;
+        }
+        return result;
+    }
+
+    // Text form, e.g. "precise_sleeping:10" for a 10us sleep, see
+    // {@link parse}.
+    std::string str() const
+    {
+        std::ostringstream out;
+        out << optionName(option_);
+        if (sleep_.count() != 0) {
+            out << ":" << sleep_.count();
+        }
+        return out.str();
+    }
+
+    // Read back the text form of a config.
+    //
+    // @return false if text is not a config.
+    static bool parse(const std::string& text, WaitConfig& config)
+    {
+        const std::string name = text.substr(0, text.find(':'));
+        int64_t sleep_us = 0;
+        if (name.size() != text.size()) {
+            std::istringstream in(text.substr(name.size() + 1));
+            if (!(in >> sleep_us) || !in.eof() || sleep_us < 0) {
+                return false;
+            }
+        }
+        for (int option = kBlockingStrategy; option < kTunableStrategy; ++option) {
+            if (name == optionName(static_cast<WaitStrategyOption>(option))) {
+                config = WaitConfig(static_cast<WaitStrategyOption>(option),
+                                    stdext::chrono::microseconds(sleep_us));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static const char* optionName(WaitStrategyOption option)
+    {
+        switch (option) {
+            case kBlockingStrategy:        return "blocking";
+            case kSleepingStrategy:        return "sleeping";
+            case kYieldingStrategy:        return "yielding";
+            case kBusySpinStrategy:        return "busy_spin";
+            case kPreciseSleepingStrategy: return "precise_sleeping";
+            case kTunableStrategy:         return "tunable";
+            default:                       return "unknown";
+        }
+    }
+
+    WaitStrategyOption           option_;
+    // kSleep of the strategy, 0 for its default.
+    stdext::chrono::microseconds sleep_;
+};
+
+// Candidates of a {@link kTunableStrategy}, from the lowest latency to the
+// lowest CPU use.
+inline std::vector<WaitConfig> defaultWaitCandidates()
+{
+    std::vector<WaitConfig> candidates;
+    candidates.push_back(WaitConfig(kYieldingStrategy));
+    candidates.push_back(WaitConfig(kBusySpinStrategy));
+    candidates.push_back(WaitConfig(kPreciseSleepingStrategy,
+                                    stdext::chrono::microseconds(10)));
+    candidates.push_back(WaitConfig(kPreciseSleepingStrategy,
+                                    stdext::chrono::microseconds(100)));
+    candidates.push_back(WaitConfig(kSleepingStrategy,
+                                    stdext::chrono::microseconds(1000)));
+    candidates.push_back(WaitConfig(kBlockingStrategy));
+    return candidates;
+}
+
+inline WaitStrategyPtr createWaitStrategy(WaitStrategyOption wait_option,
+                                          const TimeConfig& timeConfig);
+
+// Waits with one of several candidate strategies, which can be switched
+// while the ring is live.
+//
+// Every candidate is built up front and registered with the barriers, so
+// switching is a single store. The switch is meant to be made on the waiting
+// thread itself, as {@link WaitStrategyTuner} does: a thread already waiting
+// in the previous candidate is signalled, but may otherwise sleep there until
+// its timeout.
+class TunableWaitStrategy : public IWaitStrategy
+{
+public:
+    // @param candidates to switch between, the first one is used first.
+    // @param timeConfig the candidates are built with, kSleep aside.
+    TunableWaitStrategy(const std::vector<WaitConfig>& candidates,
+                        const TimeConfig& timeConfig = TimeConfig())
+        : candidates_(candidates)
+        , current_(0)
+    {
+        assert(!candidates.empty());
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            assert(candidates[i].option_ != kTunableStrategy);
+            strategies_.push_back(createWaitStrategy(candidates[i].option_,
+                        candidates[i].timeConfig(timeConfig)));
+        }
+    }
+
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const Sequence& cursor,
+                            const DependentSequences& dependents,
+                            const ISequenceBarrier& barrier)
+    {
+        return strategy()->waitFor(sequence, cursor, dependents, barrier);
+    }
+
+    virtual int64_t waitFor(const int64_t& sequence,
+                            const Sequence& cursor,
+                            const DependentSequences& dependents,
+                            const ISequenceBarrier& barrier,
+                            const stdext::chrono::microseconds& timeout)
+    {
+        return strategy()->waitFor(sequence, cursor, dependents, barrier,
+                                   timeout);
+    }
+
+    virtual void signalAllWhenBlocking()
+    {
+        strategy()->signalAllWhenBlocking();
+    }
+
+    virtual void signalWhenBlocking(const Sequence& sequence)
+    {
+        strategy()->signalWhenBlocking(sequence);
+    }
+
+    virtual void addWaitQueue(WaitQueue* queue,
+                              const DependentSequences& sequences)
+    {
+        for (size_t i = 0; i < strategies_.size(); ++i) {
+            strategies_[i]->addWaitQueue(queue, sequences);
+        }
+    }
+
+    virtual void removeWaitQueue(WaitQueue* queue)
+    {
+        for (size_t i = 0; i < strategies_.size(); ++i) {
+            strategies_[i]->removeWaitQueue(queue);
+        }
+    }
+
+    // Wait with another candidate from now on.
+    //
+    // @param index of the candidate.
+    void select(size_t index)
+    {
+        assert(index < strategies_.size());
+        size_t previous = current_.exchange(index);
+        if (previous != index) {
+            strategies_[previous]->signalAllWhenBlocking();
+        }
+    }
+
+    size_t selected() const
+    {
+        return current_.load(stdext::memory_order_relaxed);
+    }
+
+    const std::vector<WaitConfig>& candidates() const
+    {
+        return candidates_;
+    }
+
+private:
+    IWaitStrategy* strategy() const
+    {
+        return strategies_[current_.load(stdext::memory_order_acquire)].get();
+    }
+
+    const std::vector<WaitConfig> candidates_;
+    std::vector<WaitStrategyPtr>  strategies_;
+    stdext::atomic<size_t>        current_;
+};
+
 inline WaitStrategyPtr createWaitStrategy(WaitStrategyOption wait_option,
                                           const TimeConfig& timeConfig)
 {
@@ -378,6 +985,19 @@ inline WaitStrategyPtr createWaitStrategy(WaitStrategyOption wait_option,
             return stdext::make_shared<YieldingStrategy>();
         case kBusySpinStrategy:
             return stdext::make_shared<BusySpinStrategy>();
+        case kPreciseSleepingStrategy: {
+            // steps do not grow unless asked to, for steady reaction times
+            stdext::chrono::microseconds min_sleep = getTimeConfig(timeConfig,
+                    kSleep, stdext::chrono::microseconds(DEFAULT_PRECISE_SLEEP_US));
+            return stdext::make_shared<PreciseSleepingStrategy>(
+                    min_sleep,
+                    getTimeConfig(timeConfig, kMaxSleep, min_sleep),
+                    getTimeConfig(timeConfig, kTimerSlack,
+                        stdext::chrono::microseconds(DEFAULT_TIMER_SLACK_US)));
+        }
+        case kTunableStrategy:
+            return stdext::make_shared<TunableWaitStrategy>(
+                    defaultWaitCandidates(), timeConfig);
         default:
             return WaitStrategyPtr();
     }
@@ -0,0 +1,322 @@
+#ifndef DISRUPTOR_WAIT_STRATEGY_TUNER_H_
+#define DISRUPTOR_WAIT_STRATEGY_TUNER_H_
+
+#include <time.h>
+
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <disruptor/interface.h>
+#include <disruptor/latency_histogram.h>
+#include <disruptor/wait_strategy.h>
+
+namespace disruptor {
+
+enum TuningObjective {
+    // lowest p99 wake up latency among the candidates within the CPU budget
+    kLowestLatency,
+    // lowest CPU use among the candidates within the latency target
+    kLowestCpu
+};
+
+// How a {@link WaitStrategyTuner} evaluates the candidates.
+struct TunerConfig
+{
+    TunerConfig()
+        : objective_(kLowestLatency)
+        , cpu_budget_(1.0)
+        , latency_target_(100)
+        , trial_(100000)
+        , reevaluate_every_(60L * 1000 * 1000)
+        , min_trial_batches_(100)
+    {
+    }
+
+    TuningObjective              objective_;
+    // share of a core the consumer thread may use, for kLowestLatency.
+    double                       cpu_budget_;
+    // p99 wake up latency to stay within, for kLowestCpu.
+    stdext::chrono::microseconds latency_target_;
+    // time each candidate is tried for.
+    stdext::chrono::microseconds trial_;
+    // time between two evaluations, 0 to evaluate only once.
+    stdext::chrono::microseconds reevaluate_every_;
+    // batches under which a trial is inconclusive, e.g. the feed was quiet.
+    int64_t                      min_trial_batches_;
+};
+
+// What a candidate achieved during its last trial.
+struct TrialResult
+{
+    TrialResult() : p99_ns_(0), cpu_(0.0), batches_(0) {}
+
+    WaitConfig config_;
+    // p99 delay between the publication of the first event of a batch and
+    // its handling.
+    int64_t    p99_ns_;
+    // share of a core the consumer thread used.
+    double     cpu_;
+    int64_t    batches_;
+};
+
+// Picks the wait strategy of a live ring, by trying each candidate of its
+// {@link TunableWaitStrategy} on the real feed.
+//
+// The tuner wraps the handler of the consumer and runs on its thread. Each
+// candidate is used for a trial period while the tuner measures the wake up
+// latency, from the publication of the first event of each batch to its
+// handling, and the CPU time of the thread. The best candidate for the
+// objective is then kept until the next evaluation. Events are handed to the
+// wrapped handler unchanged all along.
+//
+// The chosen config can be saved with {@link WaitConfig#str} and used to
+// build the ring directly next time.
+//
+//   WaitStrategyTuner<Event> tuner(&handler, publishTime, TunerConfig());
+//   Disruptor<Event> disruptor(size, kSingleThreadedStrategy,
+//                              kTunableStrategy, &tuner, NULL);
+//   tuner.attach(disruptor.getWaitStrategy());
+//
+// @param <T> event type.
+template <typename T>
+class WaitStrategyTuner : public IEventHandler<T>
+{
+public:
+    // Publish time of an event, in nanoseconds on the CLOCK_MONOTONIC
+    // timeline, see {@link monotonicNanos}.
+    typedef stdext::function<int64_t (const T&)> TimestampFunction;
+
+    WaitStrategyTuner(IEventHandler<T>* handler,
+                      const TimestampFunction& timestamp,
+                      const TunerConfig& config)
+        : handler_(handler)
+        , timestamp_(timestamp)
+        , config_(config)
+        , strategy_(NULL)
+        , tuning_(NULL)
+        , trial_(0)
+        , deadline_ns_(0)
+        , batch_head_(true)
+        , batches_(0)
+        , trial_start_ns_(0)
+        , trial_start_cpu_ns_(0)
+        , evaluations_(0)
+    {
+    }
+
+    // Start tuning the wait strategy of a ring, from its next batch on.
+    //
+    // @param strategy of the ring, see {@link Sequencer#getWaitStrategy}.
+    // @throws std::invalid_argument if it is not a {@link TunableWaitStrategy}.
+    void attach(IWaitStrategy* strategy)
+    {
+        TunableWaitStrategy* tunable = dynamic_cast<TunableWaitStrategy*>(strategy);
+        if (tunable == NULL) {
+            throw std::invalid_argument("Wait strategy is not tunable");
+        }
+
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        results_.assign(tunable->candidates().size(), TrialResult());
+        for (size_t i = 0; i < results_.size(); ++i) {
+            results_[i].config_ = tunable->candidates()[i];
+        }
+        chosen_ = tunable->candidates()[tunable->selected()];
+        tuning_.store(tunable, stdext::memory_order_release);
+    }
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         T* event)
+    {
+        if (event != NULL && batch_head_ && trial_ >= 0 && strategy_ != NULL) {
+            latency_.record(monotonicNanos() - timestamp_(*event));
+            ++batches_;
+        }
+        batch_head_ = event == NULL || end_of_batch;
+
+        handler_->onEvent(sequence, batch_size, end_of_batch, event);
+
+        if (batch_head_) {
+            step();
+        }
+    }
+
+    virtual void onStart()
+    {
+        handler_->onStart();
+    }
+
+    virtual void onShutdown()
+    {
+        handler_->onShutdown();
+    }
+
+    virtual void onWarmUp(const bool& warming_up)
+    {
+        handler_->onWarmUp(warming_up);
+    }
+
+    // Config picked by the last evaluation, the first candidate before.
+    WaitConfig chosen() const
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return chosen_;
+    }
+
+    // Results of the last trial of every candidate.
+    std::vector<TrialResult> results() const
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return results_;
+    }
+
+    // Number of evaluations completed so far.
+    int64_t evaluations() const
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return evaluations_;
+    }
+
+private:
+    static int64_t threadCpuNanos()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return now.tv_sec * 1000000000L + now.tv_nsec;
+    }
+
+    // Move on to the next trial or evaluation when due, between batches.
+    void step()
+    {
+        if (strategy_ == NULL) {
+            strategy_ = tuning_.load(stdext::memory_order_acquire);
+            if (strategy_ == NULL) {
+                return;
+            }
+            startTrial(0);
+            return;
+        }
+
+        const int64_t now = monotonicNanos();
+        if (now < deadline_ns_) {
+            return;
+        }
+
+        if (trial_ < 0) {
+            // time for another evaluation
+            startTrial(0);
+            return;
+        }
+
+        endTrial(now);
+        if ((size_t)trial_ + 1 < results_.size()) {
+            startTrial(trial_ + 1);
+        }
+        else {
+            choose(now);
+        }
+    }
+
+    void startTrial(int trial)
+    {
+        trial_ = trial;
+        strategy_->select(trial);
+        latency_.reset();
+        batches_ = 0;
+        trial_start_ns_ = monotonicNanos();
+        trial_start_cpu_ns_ = threadCpuNanos();
+        deadline_ns_ = trial_start_ns_ + (int64_t)config_.trial_.count() * 1000;
+    }
+
+    void endTrial(const int64_t& now)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        TrialResult& result = results_[trial_];
+        result.p99_ns_ = latency_.percentile(0.99);
+        result.cpu_ = (double)(threadCpuNanos() - trial_start_cpu_ns_)
+            / std::max<int64_t>(now - trial_start_ns_, 1);
+        result.batches_ = batches_;
+    }
+
+    void choose(const int64_t& now)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        const int64_t target_ns = (int64_t)config_.latency_target_.count() * 1000;
+
+        int best = -1;
+        int fallback = -1;
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const TrialResult& result = results_[i];
+            if (result.batches_ < config_.min_trial_batches_) {
+                continue;
+            }
+            // the best within the constraint, else the closest to it
+            if (config_.objective_ == kLowestLatency) {
+                if (result.cpu_ <= config_.cpu_budget_
+                        && (best < 0 || result.p99_ns_ < results_[best].p99_ns_)) {
+                    best = i;
+                }
+                if (fallback < 0 || result.cpu_ < results_[fallback].cpu_) {
+                    fallback = i;
+                }
+            }
+            else {
+                if (result.p99_ns_ <= target_ns
+                        && (best < 0 || result.cpu_ < results_[best].cpu_)) {
+                    best = i;
+                }
+                if (fallback < 0 || result.p99_ns_ < results_[fallback].p99_ns_) {
+                    fallback = i;
+                }
+            }
+        }
+
+        if (best < 0) {
+            best = fallback;
+        }
+        if (best < 0) {
+            // no trial was conclusive, keep what was chosen before
+            best = 0;
+            for (size_t i = 0; i < results_.size(); ++i) {
+                if (results_[i].config_.str() == chosen_.str()) {
+                    best = i;
+                }
+            }
+        }
+
+        strategy_->select(best);
+        chosen_ = results_[best].config_;
+        ++evaluations_;
+        trial_ = -1;
+        deadline_ns_ = config_.reevaluate_every_.count() == 0
+            ? std::numeric_limits<int64_t>::max()
+            : now + (int64_t)config_.reevaluate_every_.count() * 1000;
+    }
+
+    IEventHandler<T>*                    handler_;
+    const TimestampFunction              timestamp_;
+    const TunerConfig                    config_;
+
+    // processor thread only, but for tuning_
+    TunableWaitStrategy*                 strategy_;
+    stdext::atomic<TunableWaitStrategy*> tuning_;
+    // candidate on trial, -1 between evaluations
+    int                                  trial_;
+    int64_t                              deadline_ns_;
+    bool                                 batch_head_;
+    LatencyHistogram                     latency_;
+    int64_t                              batches_;
+    int64_t                              trial_start_ns_;
+    int64_t                              trial_start_cpu_ns_;
+
+    mutable stdext::mutex                mutex_;
+    std::vector<TrialResult>             results_;
+    WaitConfig                           chosen_;
+    int64_t                              evaluations_;
+};
+
+}
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef DISRUPTOR_WORK_STEALING_POOL_H_
+#define DISRUPTOR_WORK_STEALING_POOL_H_
+
+#include <disruptor/cooperative_executor.h>
+
+namespace disruptor {
+
+const int DEFAULT_STEALING_IDLE_SPINS = 100;
+
+// Consumer threads over a set of independent rings, each wrapped in an
+// {@link IPollable} such as a {@link CooperativeEventProcessor}.
+//
+// Every ring is owned by one thread, which polls its own rings first. A thread
+// whose rings are all dry steals a single batch at a time from the rings of
+// the other threads. Whoever polls a ring holds an exclusive claim on it for
+// the duration of the batch, so the ring's processing sequence only ever moves
+// forward from one thread at a time and per-ring ordering is preserved.
+class WorkStealingPool
+{
+public:
+    // @param num_threads of the pool.
+    // @param max_batch events processed per claim of a ring.
+    // @param idle_spins rounds with nothing to do before yielding.
+    WorkStealingPool(int num_threads,
+                     int64_t max_batch = DEFAULT_EXECUTOR_BATCH_SIZE,
+                     int idle_spins = DEFAULT_STEALING_IDLE_SPINS)
+        : max_batch_(max_batch)
+        , idle_spins_(idle_spins)
+        , running_(false)
+        , workers_(num_threads)
+    {
+    }
+
+    ~WorkStealingPool()
+    {
+        stop();
+        for (size_t i = 0; i < rings_.size(); ++i) {
+            delete rings_[i];
+        }
+    }
+
+    // Register a ring before the pool is started.
+    //
+    // @param pollable to run, must outlive the pool.
+    // @param owner index of the thread owning the ring.
+    void add(IPollable* pollable, int owner)
+    {
+        Ring* ring = new Ring(pollable);
+        rings_.push_back(ring);
+        workers_[owner % workers_.size()].rings_.push_back(ring);
+    }
+
+    void start()
+    {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::runtime_error("Pool is already running");
+        }
+
+        for (size_t i = 0; i < workers_.size(); ++i) {
+            threads_.push_back(stdext::make_shared<stdext::thread>(
+                        stdext::bind(&WorkStealingPool::run, this, i)));
+        }
+    }
+
+    // Join the pool and call onShutdown on every ring that was started.
+    void stop()
+    {
+        bool expected = true;
+        if (!running_.compare_exchange_strong(expected, false)) {
+            return;
+        }
+
+        for (size_t i = 0; i < threads_.size(); ++i) {
+            threads_[i]->join();
+        }
+        threads_.clear();
+
+        for (size_t i = 0; i < rings_.size(); ++i) {
+            if (rings_[i]->started_) {
+                rings_[i]->pollable_->onShutdown();
+                rings_[i]->started_ = false;
+            }
+        }
+    }
+
+    // Number of batches the given thread took from rings it doesn't own.
+    int64_t stolen(int thread) const
+    {
+        return workers_[thread].stolen_.get(stdext::memory_order_relaxed);
+    }
+
+private:
+    struct Ring : private stdext::noncopyable
+    {
+        explicit Ring(IPollable* pollable)
+            : pollable_(pollable)
+            , claimed_(false)
+            , started_(false)
+        {
+        }
+
+        // Exclusive claim, acquire pairs with the release in unclaim so the
+        // next claimer sees the processing sequence of the previous batch.
+        bool claim()
+        {
+            bool expected = false;
+            return !claimed_.load(stdext::memory_order_relaxed)
+                && claimed_.compare_exchange_strong(expected, true,
+                        stdext::memory_order_acquire);
+        }
+
+        void unclaim()
+        {
+            claimed_.store(false, stdext::memory_order_release);
+        }
+
+        IPollable*           pollable_;
+        stdext::atomic<bool> claimed_;
+        bool                 started_;
+    };
+
+    struct Worker
+    {
+        Worker() : stolen_(0) {}
+
+        // copied only when the pool is built
+        Worker(const Worker& w) : rings_(w.rings_), stolen_(0) {}
+
+        std::vector<Ring*> rings_;
+        Sequence           stolen_;
+    };
+
+    int64_t pollRing(Ring* ring)
+    {
+        if (!ring->claim()) {
+            return 0;
+        }
+
+        if (!ring->started_) {
+            ring->pollable_->onStart();
+            ring->started_ = true;
+        }
+        int64_t processed = ring->pollable_->poll(max_batch_);
+        ring->unclaim();
+        return processed;
+    }
+
+    void run(size_t self)
+    {
+        Worker& worker = workers_[self];
+        size_t victim = self;
+        // first ring tried on a victim, moving on every steal so that thieves
+        // do not all contend on the same ring
+        size_t offset = self;
+        int idle = 0;
+
+        while (running_.load(stdext::memory_order_relaxed)) {
+            int64_t processed = 0;
+            for (size_t i = 0; i < worker.rings_.size(); ++i) {
+                processed += pollRing(worker.rings_[i]);
+            }
+
+            // own rings are dry, steal one batch, victims taken round robin
+            for (size_t n = 1; processed == 0 && n < workers_.size(); ++n) {
+                victim = (victim + 1) % workers_.size();
+                if (victim == self) {
+                    victim = (victim + 1) % workers_.size();
+                }
+                std::vector<Ring*>& rings = workers_[victim].rings_;
+                for (size_t i = 0; processed == 0 && i < rings.size(); ++i) {
+                    processed = pollRing(rings[(offset + i) % rings.size()]);
+                }
+                ++offset;
+                if (processed > 0) {
+                    worker.stolen_.incrementAndGet(1L, stdext::memory_order_relaxed);
+                }
+            }
+
+            if (processed > 0) {
+                idle = 0;
+            }
+            else if (++idle >= idle_spins_) {
+                stdext::this_thread::yield();
+            }
+        }
+    }
+
+    const int64_t               max_batch_;
+    const int                   idle_spins_;
+    stdext::atomic<bool>        running_;
+    std::vector<Ring*>          rings_;
+    std::vector<Worker>         workers_;
+    std::vector< stdext::shared_ptr<stdext::thread> > threads_;
+};
+
+}
+
+#endif
@@ -0,0 +1,311 @@
+#ifndef DISRUPTOR_WORKER_POOL_H_
+#define DISRUPTOR_WORKER_POOL_H_
+
+#include <limits>
+
+#include <disruptor/ring_buffer.h>
+
+namespace disruptor {
+
+const int64_t DEFAULT_WORKER_POOL_SAMPLE_INTERVAL_US = 1000;
+const int DEFAULT_WORKER_POOL_HYSTERESIS = 5;
+
+// Sequence value of a worker slot nobody runs on, never gates publishers.
+const int64_t IDLE_WORKER_SEQUENCE = std::numeric_limits<int64_t>::max();
+
+// Bounds and thresholds driving an {@link ElasticWorkerPool}. The lag is the
+// cursor minus the work sequence, i.e. events published but not claimed yet.
+struct ElasticityConfig
+{
+    ElasticityConfig(int min, int max,
+                     int64_t grow_above,
+                     int64_t shrink_below)
+        : min_workers(min)
+        , max_workers(max)
+        , grow_lag(grow_above)
+        , shrink_lag(shrink_below)
+        , hysteresis(DEFAULT_WORKER_POOL_HYSTERESIS)
+        , sample_interval(DEFAULT_WORKER_POOL_SAMPLE_INTERVAL_US)
+    {
+    }
+
+    // number of workers never goes below min_workers, which must be >= 1
+    int min_workers;
+    int max_workers;
+    // add a worker when the lag is above grow_lag and not shrinking
+    int64_t grow_lag;
+    // retire a worker when the lag is below shrink_lag
+    int64_t shrink_lag;
+    // consecutive samples a condition must hold before acting on it
+    int hysteresis;
+    stdext::chrono::microseconds sample_interval;
+};
+
+// Pool of competing consumers on a {@link RingBuffer} whose size follows the
+// lag: every event is handled by exactly one worker, which claims it by
+// advancing the shared work sequence.
+//
+// Each of the max_workers slots owns a {@link Sequence} registered once as a
+// gating sequence, an idle slot holds IDLE_WORKER_SEQUENCE. A worker joining
+// pulls its sequence down to the work sequence before claiming anything, a
+// worker leaving only does so between two events and parks its sequence back,
+// so the gating set itself never changes while publishers are running. One
+// more sequence is pinned at the work sequence whenever the pool is stopped,
+// so publishers never see every gating sequence idle and wrap over events
+// nobody claimed.
+//
+// The handler is shared by all workers and called concurrently, onStart and
+// onShutdown are called on every worker thread joining or leaving.
+//
+// @param <T> event type stored in the {@link RingBuffer}.
+template <typename T>
+class ElasticWorkerPool
+{
+public:
+    ElasticWorkerPool(RingBuffer<T>* ring_buffer,
+                      SequenceBarrierPtr sequence_barrier,
+                      IEventHandler<T>* event_handler,
+                      IExceptionHandler<T>* exception_handler,
+                      const ElasticityConfig& config,
+                      const stdext::chrono::microseconds& max_idle_time)
+        : ring_buffer_(ring_buffer)
+        , event_handler_(event_handler)
+        , exception_handler_(exception_handler)
+        , config_(config)
+        , wait_(max_idle_time)
+        , running_(false)
+        , active_(0)
+        , slots_(new Slot[config.max_workers])
+        , stopped_sequence_(INITIAL_CURSOR_VALUE)
+    {
+        assert(config_.min_workers >= 1);
+        assert(config_.min_workers <= config_.max_workers);
+        for (int i = 0; i < config_.max_workers; ++i) {
+            slots_[i].barrier_ =
+                stdext::make_shared<InterruptibleSequenceBarrier>(sequence_barrier);
+        }
+    }
+
+    ~ElasticWorkerPool()
+    {
+        halt();
+    }
+
+    // Sequences to be gated on by the ring buffer, one per slot and the one
+    // held while stopped.
+    DependentSequences getWorkerSequences()
+    {
+        DependentSequences sequences;
+        for (int i = 0; i < config_.max_workers; ++i) {
+            sequences.push_back(&slots_[i].sequence_);
+        }
+        sequences.push_back(&stopped_sequence_);
+        return sequences;
+    }
+
+    // Start min_workers workers and the monitor adjusting their number.
+    // Consumption starts with the first event ever published, and resumes
+    // after the last sequence claimed before a halt.
+    void start()
+    {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::runtime_error("Pool is already running");
+        }
+
+        while (active_ < config_.min_workers) {
+            grow();
+        }
+        // the workers gate publishers from now on
+        stopped_sequence_.set(IDLE_WORKER_SEQUENCE);
+        ring_buffer_->signal(stopped_sequence_);
+
+        stdext::thread monitor(stdext::bind(&ElasticWorkerPool::monitor, this));
+        monitor_thread_.swap(monitor);
+    }
+
+    // Stop every worker, events published but not yet claimed are left in
+    // the ring and keep gating publishers.
+    void halt()
+    {
+        bool expected = true;
+        if (!running_.compare_exchange_strong(expected, false)) {
+            return;
+        }
+
+        monitor_thread_.join();
+        // gate publishers before the workers go idle, the work sequence can
+        // only move forward until they are all gone
+        stopped_sequence_.set(work_sequence_.get());
+        for (int i = 0; i < config_.max_workers; ++i) {
+            slots_[i].running_.store(false);
+            slots_[i].barrier_->interrupt();
+        }
+        for (int i = 0; i < config_.max_workers; ++i) {
+            if (slots_[i].thread_.joinable()) {
+                slots_[i].thread_.join();
+            }
+        }
+        active_ = 0;
+        stopped_sequence_.set(work_sequence_.get());
+    }
+
+    int activeWorkers() const { return active_.load(); }
+
+    // Number of events published but not claimed by any worker yet.
+    int64_t lag() const
+    {
+        return ring_buffer_->getCursor() - work_sequence_.get();
+    }
+
+private:
+    struct Slot : private stdext::noncopyable
+    {
+        Slot()
+            : sequence_(IDLE_WORKER_SEQUENCE)
+            , running_(false)
+        {
+        }
+
+        Sequence             sequence_;
+        stdext::atomic<bool> running_;
+        stdext::thread       thread_;
+        // interrupted to retire the worker without waiting for an event
+        stdext::shared_ptr<InterruptibleSequenceBarrier> barrier_;
+    };
+
+    void grow()
+    {
+        for (int i = 0; i < config_.max_workers; ++i) {
+            Slot& slot = slots_[i];
+            // a retired worker may still be finishing its last event
+            if (slot.running_.load() || (slot.thread_.joinable()
+                        && slot.sequence_.get() != IDLE_WORKER_SEQUENCE)) {
+                continue;
+            }
+            if (slot.thread_.joinable()) {
+                slot.thread_.join();
+            }
+
+            // gate publishers before the worker may claim anything
+            slot.sequence_.set(work_sequence_.get());
+            slot.running_.store(true);
+            stdext::thread worker(stdext::bind(&ElasticWorkerPool::work, this, i));
+            slot.thread_.swap(worker);
+            ++active_;
+            return;
+        }
+    }
+
+    void shrink()
+    {
+        for (int i = config_.max_workers - 1; i >= 0; --i) {
+            if (slots_[i].running_.load()) {
+                // the worker leaves after the event at hand, if any
+                slots_[i].running_.store(false);
+                slots_[i].barrier_->interrupt();
+                --active_;
+                return;
+            }
+        }
+    }
+
+    void monitor()
+    {
+        int64_t last_lag = lag();
+        int grow_votes = 0;
+        int shrink_votes = 0;
+
+        while (running_.load()) {
+            stdext::this_thread::sleep_for(config_.sample_interval);
+
+            const int64_t current_lag = lag();
+            const bool growing = current_lag > config_.grow_lag
+                && current_lag >= last_lag;
+            const bool shrinking = current_lag < config_.shrink_lag;
+            last_lag = current_lag;
+
+            grow_votes = growing ? grow_votes + 1 : 0;
+            shrink_votes = shrinking ? shrink_votes + 1 : 0;
+
+            if (grow_votes >= config_.hysteresis
+                    && active_ < config_.max_workers) {
+                grow();
+                grow_votes = 0;
+            }
+            else if (shrink_votes >= config_.hysteresis
+                    && active_ > config_.min_workers) {
+                shrink();
+                shrink_votes = 0;
+            }
+        }
+    }
+
+    void work(int index)
+    {
+        Slot& slot = slots_[index];
+        event_handler_->onStart();
+
+        T* event = NULL;
+        int64_t next_sequence = INITIAL_CURSOR_VALUE;
+        while (slot.running_.load(stdext::memory_order_relaxed)) {
+            try {
+                // only claim what is published, so leaving never strands a
+                // claimed sequence
+                const int64_t current_sequence = work_sequence_.get();
+                next_sequence = current_sequence + 1L;
+                slot.sequence_.set(current_sequence);
+                ring_buffer_->signal(slot.sequence_);
+
+                int64_t available_sequence =
+                    slot.barrier_->waitFor(next_sequence, wait_);
+                if (available_sequence < next_sequence
+                        || !work_sequence_.compareAndExchange(
+                            current_sequence, next_sequence)) {
+                    continue;
+                }
+
+                event = ring_buffer_->get(next_sequence);
+                event_handler_->onEvent(next_sequence, 1, true, event);
+            }
+            catch(const AlertException& e) {
+                if (slot.barrier_->isSharedAlerted()) {
+                    break;
+                }
+                // retired or halted, running_ tells
+                slot.barrier_->clearInterrupt();
+            }
+            catch(const std::exception& e) {
+                if (exception_handler_) {
+                    exception_handler_->handle(e, next_sequence, event);
+                }
+            }
+        }
+
+        event_handler_->onShutdown();
+        slot.sequence_.set(IDLE_WORKER_SEQUENCE);
+        ring_buffer_->signal(slot.sequence_);
+    }
+
+    RingBuffer<T>*               ring_buffer_;
+    IEventHandler<T>*            event_handler_;
+    IExceptionHandler<T>*        exception_handler_;
+    const ElasticityConfig       config_;
+    stdext::chrono::microseconds wait_;
+
+    Sequence                     work_sequence_;
+    stdext::atomic<bool>         running_;
+    stdext::atomic<int>          active_;
+#ifdef has_cplusplus11
+    std::unique_ptr<Slot[]>      slots_;
+#else
+    boost::scoped_array<Slot>    slots_;
+#endif
+    // work sequence while stopped, IDLE_WORKER_SEQUENCE while running
+    Sequence                     stopped_sequence_;
+    stdext::thread               monitor_thread_;
+};
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+#include <time.h>
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+
+#include <disruptor/disruptor.h>
+#include <disruptor/multicast_egress.h>
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+static const int64_t EGRESS_ITERATIONS = 1000L * 1000;
+
+struct Quote
+{
+    int64_t sequence;
+    int64_t price;
+    int64_t quantity;
+};
+
+class QuoteTranslator : public IEventTranslator<Quote>
+{
+public:
+    virtual Quote* translateTo(const int64_t& sequence, Quote* event)
+    {
+        event->sequence = sequence;
+        event->price = 10000 + sequence % 7;
+        event->quantity = 100;
+        return event;
+    }
+};
+
+inline size_t encodeQuote(const Quote& quote, char* buffer, size_t capacity)
+{
+    memcpy(buffer, &quote, sizeof(quote));
+    return sizeof(quote);
+}
+
+// Sends to a loopback multicast group, nobody needs to listen.
+TEST(MulticastEgressPerfTest, PacketsPerSyscallOnLoopback)
+{
+    const size_t batches[] = { 1, 8, 64 };
+    for (size_t i = 0; i < sizeof(batches) / sizeof(batches[0]); ++i) {
+        MulticastConfig config("239.255.0.1", 30001);
+        config.interface_ = "127.0.0.1";
+        config.max_batch_ = batches[i];
+        MulticastEgressHandler<Quote> handler(config,
+                boost::bind(&encodeQuote, _1, _2, _3));
+        QuoteTranslator translator;
+
+        struct timespec start_time, end_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        {
+            Disruptor<Quote> disruptor(1024 * 8, kSingleThreadedStrategy,
+                                       kYieldingStrategy, &handler, NULL);
+            for (int64_t j = 0; j < EGRESS_ITERATIONS; ++j) {
+                disruptor.publishEvent(&translator);
+            }
+            while (disruptor.processor().getSequence()->get()
+                    < EGRESS_ITERATIONS - 1) {
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        double duration = (end_time.tv_sec - start_time.tv_sec)
+            + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+        std::cout.precision(15);
+        std::cout << "max batch " << batches[i] << ": "
+                  << handler.packets() / duration << " packets/secs, "
+                  << handler.packetsPerSyscall() << " packets per syscall, "
+                  << handler.errors() << " errors" << std::endl;
+        EXPECT_EQ(EGRESS_ITERATIONS, handler.packets() + handler.errors());
+    }
+}
+
+}
+}
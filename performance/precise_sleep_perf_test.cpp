@@ -0,0 +1,104 @@
+#include <iostream>
+
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+
+#include <disruptor/event_processor.h>
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+// Events are published one at a time, far enough apart for the consumer to
+// fall asleep in between.
+static const int64_t PRECISE_SLEEP_EVENTS = 2000;
+static const int64_t PRECISE_SLEEP_GAP_US = 300;
+static const int64_t PRECISE_SLEEP_STEP_US = 10;
+
+// The event is its publish time, the handler measures how late it sees it.
+class ReactionHandler : public IEventHandler<int64_t>
+{
+public:
+    ReactionHandler() : events_(0), total_ns_(0), max_ns_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        int64_t reaction = monotonicNanos() - *event;
+        ++events_;
+        total_ns_ += reaction;
+        max_ns_ = std::max(max_ns_, reaction);
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    int64_t events_;
+    int64_t total_ns_;
+    int64_t max_ns_;
+};
+
+class PreciseSleepPerfTest : public ::testing::Test
+{
+protected:
+    void run(const WaitStrategyOption& option, const int64_t& slack_us)
+    {
+        TimeConfig time_config;
+        time_config[kSleep] =
+            stdext::chrono::microseconds(PRECISE_SLEEP_STEP_US);
+        time_config[kTimerSlack] = stdext::chrono::microseconds(slack_us);
+        RingBuffer<int64_t> ring_buffer(1024, kSingleThreadedStrategy,
+                                        option, time_config);
+        ReactionHandler handler;
+        BatchEventProcessor<int64_t> processor(&ring_buffer,
+                ring_buffer.newBarrier(DependentSequences()),
+                &handler, NULL, stdext::chrono::microseconds(1000 * 1000));
+        ring_buffer.setGatingSequences(
+                DependentSequences(1, processor.getSequence()));
+
+        boost::thread consumer(boost::ref(processor));
+        for (int64_t i = 0; i < PRECISE_SLEEP_EVENTS; ++i) {
+            boost::this_thread::sleep(
+                    boost::posix_time::microseconds(PRECISE_SLEEP_GAP_US));
+            int64_t sequence = ring_buffer.next();
+            *ring_buffer.get(sequence) = monotonicNanos();
+            ring_buffer.publish(sequence);
+        }
+        while (processor.getSequence()->get() < PRECISE_SLEEP_EVENTS - 1) {}
+        processor.halt();
+        consumer.join();
+
+        std::cout << WaitConfig::optionName(option) << ", timer slack "
+                  << slack_us << "us: reaction mean "
+                  << handler.total_ns_ / handler.events_ / 1000
+                  << "us, max " << handler.max_ns_ / 1000 << "us";
+        PreciseSleepingStrategy* strategy =
+            dynamic_cast<PreciseSleepingStrategy*>(
+                    ring_buffer.getWaitStrategy());
+        if (strategy != NULL) {
+            std::cout << ", " << strategy->sleeps() << " sleeps overshooting "
+                      << strategy->overshootMeanNanos() / 1000
+                      << "us on average, "
+                      << strategy->overshootMaxNanos() / 1000 << "us at most";
+        }
+        std::cout << std::endl;
+    }
+};
+
+TEST_F(PreciseSleepPerfTest, ReactionTimeBySleepingStrategy)
+{
+    // plain sleeps are relative and keep the default timer slack
+    run(kSleepingStrategy, DEFAULT_TIMER_SLACK_US);
+    run(kPreciseSleepingStrategy, DEFAULT_TIMER_SLACK_US);
+    // the default slack of a Linux thread
+    run(kPreciseSleepingStrategy, 50);
+}
+
+}
+}
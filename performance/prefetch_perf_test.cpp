@@ -0,0 +1,116 @@
+#include <time.h>
+
+#include <iostream>
+
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+
+#include <disruptor/event_processor.h>
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+// Ring of PREFETCH_RING_BYTES so the events do not stay in the caches
+// between two laps.
+static const size_t PREFETCH_RING_BYTES = 64 * 1024 * 1024;
+static const int64_t PREFETCH_ITERATIONS = 1000L * 1000 * 10;
+
+template <size_t N>
+struct SizedEvent
+{
+    int64_t sequence;
+    char    payload[N - sizeof(int64_t)];
+};
+
+// Reads the whole event, as a decoder would.
+template <typename E>
+class ReadingHandler : public IEventHandler<E>
+{
+public:
+    ReadingHandler() : sum_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         E* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        const int64_t* words = reinterpret_cast<const int64_t*>(event);
+        for (size_t i = 0; i < sizeof(E) / sizeof(int64_t); ++i) {
+            sum_ += words[i];
+        }
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    int64_t sum_;
+};
+
+template <typename E>
+class PrefetchPerfTest : public ::testing::Test
+{
+protected:
+    // @return events handled per second.
+    double run(const int64_t& distance)
+    {
+        RingBuffer<E> ring_buffer(PREFETCH_RING_BYTES / sizeof(E),
+                                  kSingleThreadedStrategy,
+                                  kBusySpinStrategy,
+                                  TimeConfig());
+        ring_buffer.preFault();
+        ReadingHandler<E> handler;
+        BatchEventProcessor<E> processor(&ring_buffer,
+                ring_buffer.newBarrier(DependentSequences()),
+                &handler, NULL, stdext::chrono::microseconds(0));
+        processor.setPrefetchDistance(distance);
+        ring_buffer.setGatingSequences(
+                DependentSequences(1, processor.getSequence()));
+
+        struct timespec start_time, end_time;
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+        boost::thread consumer(boost::ref< BatchEventProcessor<E> >(processor));
+        for (int64_t i = 0; i < PREFETCH_ITERATIONS; ++i) {
+            int64_t sequence = ring_buffer.next();
+            // only the header is written, the rest of the event is cold
+            ring_buffer.get(sequence)->sequence = i;
+            ring_buffer.publish(sequence);
+        }
+        while (processor.getSequence()->get() < PREFETCH_ITERATIONS - 1) {}
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        processor.halt();
+        consumer.join();
+
+        double duration = (end_time.tv_sec - start_time.tv_sec)
+            + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+        return PREFETCH_ITERATIONS / duration;
+    }
+};
+
+typedef ::testing::Types<
+        SizedEvent<64>,
+        SizedEvent<256>,
+        SizedEvent<1024>
+    > PrefetchEventTypes;
+TYPED_TEST_CASE(PrefetchPerfTest, PrefetchEventTypes);
+
+TYPED_TEST(PrefetchPerfTest, ThroughputByPrefetchDistance)
+{
+    const int64_t distances[] = { 0, 1, 2, 4, 8, 16 };
+    std::cout.precision(15);
+    for (size_t i = 0; i < sizeof(distances) / sizeof(distances[0]); ++i) {
+        double throughput = this->run(distances[i]);
+        std::cout << sizeof(TypeParam) << "B events, prefetch distance "
+                  << distances[i] << ": " << throughput << " ops/secs"
+                  << std::endl;
+    }
+}
+
+}
+}
@@ -0,0 +1,107 @@
+#include <iostream>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+#include <disruptor/latency_histogram.h>
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+static const int64_t FAIRNESS_ITERATIONS = 1000L * 200;
+static const int FAIRNESS_RING_SIZE = 1024;
+
+class FairnessCountingHandler : public IEventHandler<int64_t>
+{
+public:
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+};
+
+class FairnessTranslator : public IEventTranslator<int64_t>
+{
+public:
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = sequence;
+        return event;
+    }
+};
+
+static void publishAll(Disruptor<int64_t>* disruptor,
+                       int64_t iterations,
+                       LatencyHistogram* latency)
+{
+    FairnessTranslator translator;
+    for (int64_t i = 0; i < iterations; ++i) {
+        disruptor->publishEvent(&translator, latency);
+    }
+}
+
+class ProducerFairnessPerfTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void run(ClaimStrategyOption claim_strategy, const char* name)
+    {
+        const int producers = GetParam();
+        const int64_t iterations = FAIRNESS_ITERATIONS / producers;
+        std::vector<LatencyHistogram> latencies(producers);
+
+        FairnessCountingHandler handler;
+        Disruptor<int64_t> disruptor(FAIRNESS_RING_SIZE, claim_strategy,
+                                     kYieldingStrategy, &handler, NULL);
+        boost::thread_group threads;
+        for (int i = 0; i < producers; ++i) {
+            threads.create_thread(boost::bind(&publishAll, &disruptor,
+                                              iterations, &latencies[i]));
+        }
+        threads.join_all();
+        while (disruptor.processor().getSequence()->get()
+                < producers * iterations - 1) {
+            boost::this_thread::yield();
+        }
+
+        // per-producer p99.9, the spread shows how unfair the claim is
+        LatencyHistogram all;
+        int64_t best = LONG_MAX;
+        int64_t worst = 0;
+        for (int i = 0; i < producers; ++i) {
+            const int64_t p999 = latencies[i].percentile(0.999);
+            best = std::min(best, p999);
+            worst = std::max(worst, p999);
+            all.merge(latencies[i]);
+        }
+        std::cout << producers << " producers, " << name
+                  << ": p50=" << all.percentile(0.5)
+                  << "ns p99=" << all.percentile(0.99)
+                  << "ns p99.9 per producer best=" << best
+                  << "ns worst=" << worst
+                  << "ns max=" << all.max() << "ns" << std::endl;
+    }
+};
+
+TEST_P(ProducerFairnessPerfTest, PerProducerClaimLatency)
+{
+    run(kMultiThreadedStrategy, "multi threaded");
+    // spins without ever yielding, would crawl with more producers than cores
+    if ((unsigned)GetParam() < boost::thread::hardware_concurrency()) {
+        run(kMultiThreadedLowContentionStrategy, "low contention");
+    }
+    run(kMultiThreadedFairStrategy, "fair");
+}
+
+INSTANTIATE_TEST_CASE_P(Producers, ProducerFairnessPerfTest,
+                        ::testing::Values(2, 4, 8, 16));
+
+}
+}
@@ -0,0 +1,190 @@
+#include <time.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+
+#include <iostream>
+
+#include <disruptor/disruptor.h>
+#include <disruptor/streaming_store.h>
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+static const int64_t STORE_ITERATIONS = 1000L * 1000;
+static const int STORE_RING_SIZE = 1024 * 8;
+
+// Cache misses of the calling thread, -1 if perf events are not available.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter() : fd_(-1)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~CacheMissCounter()
+    {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    int64_t read() const
+    {
+        int64_t count;
+        if (fd_ < 0 || ::read(fd_, &count, sizeof(count)) != sizeof(count)) {
+            return -1;
+        }
+        return count;
+    }
+
+private:
+    int fd_;
+};
+
+// Reads every line of the events and counts its own cache misses.
+template <typename E>
+class MissCountingHandler : public IEventHandler<E>
+{
+public:
+    MissCountingHandler() : sum_(0), counter_(NULL), misses_(-1) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         E* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        const char* bytes = reinterpret_cast<const char*>(event);
+        for (size_t i = 0; i < sizeof(E); i += CACHE_LINE_SIZE_IN_BYTES) {
+            sum_ += bytes[i];
+        }
+    }
+
+    virtual void onStart()
+    {
+        counter_ = new CacheMissCounter();
+        start_ = counter_->read();
+    }
+
+    virtual void onShutdown()
+    {
+        int64_t end = counter_->read();
+        misses_ = (start_ < 0 || end < 0) ? -1 : end - start_;
+        delete counter_;
+    }
+
+    int64_t misses() const { return misses_; }
+
+private:
+    int64_t           sum_;
+    CacheMissCounter* counter_;
+    int64_t           start_;
+    int64_t           misses_;
+};
+
+template <typename E>
+class MemcpyTranslator : public IEventTranslator<E>
+{
+public:
+    explicit MemcpyTranslator(const E* source) : source_(source) {}
+
+    virtual E* translateTo(const int64_t& sequence, E* event)
+    {
+        memcpy(event, source_, sizeof(E));
+        return event;
+    }
+
+private:
+    const E* source_;
+};
+
+template <size_t N>
+struct PayloadEvent
+{
+    char payload[N];
+};
+
+enum StoreMode {
+    kPlainStores,
+    kWritePrefetch,
+    kStreamingStores
+};
+
+template <typename E>
+class ProducerStorePerfTest : public ::testing::Test
+{
+protected:
+    void run(StoreMode mode, const char* name)
+    {
+        E source;
+        memset(&source, 1, sizeof(source));
+        MemcpyTranslator<E> plain(&source);
+        StreamingCopyTranslator<E> streaming;
+        streaming.setSource(&source);
+        IEventTranslator<E>* translator = mode == kStreamingStores
+            ? static_cast<IEventTranslator<E>*>(&streaming) : &plain;
+
+        MissCountingHandler<E> handler;
+        struct timespec start_time, end_time;
+        {
+            Disruptor<E> disruptor(STORE_RING_SIZE, kSingleThreadedStrategy,
+                                   kYieldingStrategy, &handler, NULL);
+            if (mode == kWritePrefetch) {
+                disruptor.setWritePrefetchDistance(2);
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &start_time);
+            for (int64_t i = 0; i < STORE_ITERATIONS; ++i) {
+                disruptor.publishEvent(translator);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+            while (disruptor.processor().getSequence()->get()
+                    < STORE_ITERATIONS - 1) {
+            }
+        }
+
+        double duration = (end_time.tv_sec - start_time.tv_sec)
+            + (end_time.tv_nsec - start_time.tv_nsec) / 1e9;
+        std::cout.precision(15);
+        std::cout << sizeof(E) << "B events, " << name << ": "
+                  << STORE_ITERATIONS / duration << " publishes/secs, ";
+        if (handler.misses() < 0) {
+            std::cout << "consumer misses n/a" << std::endl;
+        }
+        else {
+            std::cout << (double)handler.misses() / STORE_ITERATIONS
+                      << " consumer misses/event" << std::endl;
+        }
+    }
+};
+
+typedef ::testing::Types<
+        PayloadEvent<1024>,
+        PayloadEvent<2048>,
+        PayloadEvent<4096>
+    > StoreEventTypes;
+TYPED_TEST_CASE(ProducerStorePerfTest, StoreEventTypes);
+
+TYPED_TEST(ProducerStorePerfTest, ProducerThroughputAndConsumerMisses)
+{
+    this->run(kPlainStores, "memcpy");
+    this->run(kWritePrefetch, "memcpy + write prefetch");
+    this->run(kStreamingStores, "streaming stores");
+}
+
+}
+}
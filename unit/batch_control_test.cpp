@@ -0,0 +1,351 @@
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+class LastEventHandler : public IEventHandler<int64_t>
+{
+public:
+    LastEventHandler() : handled_(0), last_(INITIAL_CURSOR_VALUE) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        last_.store(*event);
+        handled_.fetch_add(1);
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    void waitFor(const int64_t& handled)
+    {
+        while (handled_.load() < handled) {
+            boost::this_thread::yield();
+        }
+    }
+
+    stdext::atomic<int64_t> handled_;
+    stdext::atomic<int64_t> last_;
+};
+
+class StampTranslator : public IEventTranslator<int64_t>
+{
+public:
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = sequence;
+        return event;
+    }
+};
+
+// Records the life cycle calls of a handler.
+class LifeCycleHandler : public LastEventHandler
+{
+public:
+    LifeCycleHandler()
+        : starts_(0)
+        , shutdowns_(0)
+        , taken_over_at_(0)
+        , previous_(NULL)
+    {
+    }
+
+    virtual void onStart() { starts_.fetch_add(1); }
+
+    virtual void onShutdown() { shutdowns_.fetch_add(1); }
+
+    virtual void onTakeOver(const int64_t& sequence,
+                            IEventHandler<int64_t>* previous)
+    {
+        taken_over_at_ = sequence;
+        previous_ = previous;
+    }
+
+    stdext::atomic<int>     starts_;
+    stdext::atomic<int>     shutdowns_;
+    int64_t                 taken_over_at_;
+    IEventHandler<int64_t>* previous_;
+};
+
+// Refuses to take over, from onStart or from onTakeOver.
+class RefusingHandler : public LifeCycleHandler
+{
+public:
+    explicit RefusingHandler(bool on_start) : on_start_(on_start) {}
+
+    virtual void onStart()
+    {
+        LifeCycleHandler::onStart();
+        if (on_start_) {
+            throw std::runtime_error("no start");
+        }
+    }
+
+    virtual void onTakeOver(const int64_t& sequence,
+                            IEventHandler<int64_t>* previous)
+    {
+        throw std::runtime_error("no take over");
+    }
+
+private:
+    const bool on_start_;
+};
+
+static void settle()
+{
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+}
+
+TEST(BatchControlTest, testPauseAndResumeRightAfterConstruction)
+{
+    LastEventHandler handler;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &handler, NULL);
+    // the consumer thread may not have started yet
+    disruptor.pause();
+    disruptor.resume();
+
+    for (int i = 0; i < 10; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    handler.waitFor(10);
+    EXPECT_EQ(9, handler.last_.load());
+    disruptor.stop();
+}
+
+TEST(BatchControlTest, testPauseHoldsEventsUntilResumed)
+{
+    LastEventHandler handler;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &handler, NULL,
+                                 TimeConfig());
+    for (int i = 0; i < 3; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    handler.waitFor(3);
+
+    disruptor.pause();
+    EXPECT_TRUE(disruptor.processor().isPaused());
+    for (int i = 0; i < 3; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    settle();
+    EXPECT_EQ(3, handler.handled_.load());
+    EXPECT_EQ(2, disruptor.processor().getSequence()->get());
+
+    disruptor.resume();
+    handler.waitFor(6);
+    EXPECT_EQ(5, handler.last_.load());
+    EXPECT_FALSE(disruptor.processor().isPaused());
+    disruptor.stop();
+}
+
+TEST(BatchControlTest, testHaltWhilePaused)
+{
+    LastEventHandler handler;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &handler, NULL);
+    disruptor.pause();
+    while (!disruptor.processor().isPaused()) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+    EXPECT_FALSE(disruptor.processor().isPaused());
+}
+
+TEST(BatchControlTest, testPauseLeavesProcessorsSharingTheBarrier)
+{
+    RingBuffer<int64_t> ring_buffer(64, kSingleThreadedStrategy,
+                                    kBlockingStrategy, TimeConfig());
+    SequenceBarrierPtr barrier = ring_buffer.newBarrier(DependentSequences());
+    LastEventHandler paused_handler;
+    LastEventHandler other_handler;
+    BatchEventProcessor<int64_t> paused(&ring_buffer, barrier,
+            &paused_handler, NULL, stdext::chrono::microseconds(1000000));
+    BatchEventProcessor<int64_t> other(&ring_buffer, barrier,
+            &other_handler, NULL, stdext::chrono::microseconds(1000000));
+    DependentSequences gating;
+    gating.push_back(paused.getSequence());
+    gating.push_back(other.getSequence());
+    ring_buffer.setGatingSequences(gating);
+
+    boost::thread paused_thread(boost::ref(paused));
+    boost::thread other_thread(boost::ref(other));
+    paused.pause();
+    while (!paused.isPaused()) {
+        boost::this_thread::yield();
+    }
+
+    StampTranslator translator;
+    for (int i = 0; i < 10; ++i) {
+        int64_t sequence = ring_buffer.next();
+        translator.translateTo(sequence, ring_buffer.get(sequence));
+        ring_buffer.publish(sequence);
+    }
+    other_handler.waitFor(10);
+    EXPECT_EQ(0, paused_handler.handled_.load());
+
+    paused.resume();
+    paused_handler.waitFor(10);
+
+    paused.halt();
+    paused_thread.join();
+    other_thread.join();
+}
+
+TEST(BatchControlTest, testSwapTakesOverAfterLastHandledEvent)
+{
+    LifeCycleHandler first;
+    LifeCycleHandler second;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &first, NULL);
+    for (int i = 0; i < 5; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    first.waitFor(5);
+
+    disruptor.swapHandler(&second);
+    EXPECT_EQ(1, second.starts_.load());
+    EXPECT_EQ(4, second.taken_over_at_);
+    EXPECT_EQ(&first, second.previous_);
+    EXPECT_EQ(1, first.shutdowns_.load());
+    EXPECT_EQ(0, second.shutdowns_.load());
+
+    for (int i = 0; i < 3; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    second.waitFor(3);
+    EXPECT_EQ(5, first.handled_.load());
+    EXPECT_EQ(7, second.last_.load());
+
+    disruptor.stop();
+    EXPECT_EQ(1, second.shutdowns_.load());
+    EXPECT_EQ(1, first.shutdowns_.load());
+}
+
+TEST(BatchControlTest, testSwapWhileIdle)
+{
+    TimeConfig time_config;
+    // without the wake up, the swap would wait for the idle timeout
+    time_config[kMaxIdle] = stdext::chrono::microseconds(60 * 1000 * 1000);
+    LifeCycleHandler first;
+    LifeCycleHandler second;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &first, NULL,
+                                 time_config);
+    disruptor.publishEvent(&translator);
+    first.waitFor(1);
+    settle();
+
+    const int64_t start = monotonicNanos();
+    disruptor.swapHandler(&second);
+    EXPECT_GT(1000L * 1000 * 1000, monotonicNanos() - start);
+    EXPECT_EQ(0, second.taken_over_at_);
+    EXPECT_EQ(1, first.shutdowns_.load());
+
+    disruptor.publishEvent(&translator);
+    second.waitFor(1);
+    disruptor.stop();
+}
+
+TEST(BatchControlTest, testSwapWhilePaused)
+{
+    LifeCycleHandler first;
+    LifeCycleHandler second;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &first, NULL);
+    disruptor.publishEvent(&translator);
+    first.waitFor(1);
+    disruptor.pause();
+
+    disruptor.swapHandler(&second);
+    EXPECT_TRUE(disruptor.processor().isPaused());
+    EXPECT_EQ(0, second.taken_over_at_);
+    EXPECT_EQ(&first, second.previous_);
+    EXPECT_EQ(1, first.shutdowns_.load());
+
+    disruptor.publishEvent(&translator);
+    settle();
+    EXPECT_EQ(0, second.handled_.load());
+
+    disruptor.resume();
+    second.waitFor(1);
+    EXPECT_EQ(1, first.handled_.load());
+    disruptor.stop();
+}
+
+TEST(BatchControlTest, testFailedSwapKeepsPreviousHandler)
+{
+    LifeCycleHandler first;
+    RefusingHandler refusing_start(true);
+    RefusingHandler refusing_take_over(false);
+    LifeCycleHandler second;
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &first, NULL);
+    for (int i = 0; i < 5; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    first.waitFor(5);
+
+    EXPECT_THROW(disruptor.swapHandler(&refusing_start), std::runtime_error);
+    EXPECT_THROW(disruptor.swapHandler(&refusing_take_over),
+                 std::runtime_error);
+    EXPECT_EQ(0, first.shutdowns_.load());
+
+    // no event is skipped
+    for (int i = 0; i < 3; ++i) {
+        disruptor.publishEvent(&translator);
+    }
+    first.waitFor(8);
+    EXPECT_EQ(7, first.last_.load());
+    EXPECT_EQ(0, refusing_start.handled_.load());
+    EXPECT_EQ(0, refusing_take_over.handled_.load());
+
+    disruptor.swapHandler(&second);
+    EXPECT_EQ(7, second.taken_over_at_);
+    EXPECT_EQ(1, first.shutdowns_.load());
+    disruptor.stop();
+}
+
+TEST(BatchControlTest, testFailedSwapWhilePaused)
+{
+    LifeCycleHandler first;
+    RefusingHandler refusing(false);
+    StampTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &first, NULL);
+    disruptor.publishEvent(&translator);
+    first.waitFor(1);
+    disruptor.pause();
+
+    EXPECT_THROW(disruptor.swapHandler(&refusing), std::runtime_error);
+    EXPECT_TRUE(disruptor.processor().isPaused());
+
+    disruptor.publishEvent(&translator);
+    disruptor.resume();
+    first.waitFor(2);
+    EXPECT_EQ(1, first.last_.load());
+    EXPECT_EQ(0, first.shutdowns_.load());
+    disruptor.stop();
+    EXPECT_EQ(1, first.shutdowns_.load());
+}
+
+}
+}
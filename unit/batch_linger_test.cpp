@@ -0,0 +1,103 @@
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+class BatchSizeHandler : public IEventHandler<int64_t>
+{
+public:
+    BatchSizeHandler() : handled_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        if (end_of_batch) {
+            stdext::unique_lock<stdext::mutex> ulock(mutex_);
+            batches_.push_back(batch_size);
+        }
+        handled_.fetch_add(1);
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    std::vector<int64_t> batches()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return batches_;
+    }
+
+    stdext::atomic<int64_t> handled_;
+
+private:
+    stdext::mutex        mutex_;
+    std::vector<int64_t> batches_;
+};
+
+class ValueTranslator : public IEventTranslator<int64_t>
+{
+public:
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = sequence;
+        return event;
+    }
+};
+
+TEST(BatchLingerTest, testWaitsForMinimumBatch)
+{
+    BatchSizeHandler handler;
+    ValueTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &handler, NULL);
+    // a batch may only be cut short by the deadline, never by a trickle
+    disruptor.processor().setLinger(8, stdext::chrono::microseconds(2000000));
+
+    for (int i = 0; i < 16; ++i) {
+        disruptor.publishEvent(&translator);
+        boost::this_thread::sleep(boost::posix_time::microseconds(500));
+    }
+    while (handler.handled_.load() < 16) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+
+    std::vector<int64_t> batches = handler.batches();
+    ASSERT_EQ(2UL, batches.size());
+    EXPECT_EQ(8, batches[0]);
+    EXPECT_EQ(8, batches[1]);
+}
+
+TEST(BatchLingerTest, testDispatchesOnDeadline)
+{
+    BatchSizeHandler handler;
+    ValueTranslator translator;
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kYieldingStrategy, &handler, NULL);
+    disruptor.processor().setLinger(8, stdext::chrono::microseconds(20000));
+
+    disruptor.publishEvent(&translator);
+    while (handler.handled_.load() < 1) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+
+    std::vector<int64_t> batches = handler.batches();
+    ASSERT_EQ(1UL, batches.size());
+    EXPECT_EQ(1, batches[0]);
+}
+
+}
+}
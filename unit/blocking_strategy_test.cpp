@@ -0,0 +1,193 @@
+#include <boost/thread.hpp>
+
+#include <disruptor/ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+// Waits on a barrier from its own thread.
+class Waiter
+{
+public:
+    Waiter(SequenceBarrierPtr barrier,
+           int64_t sequence,
+           int64_t timeout_us = 0)
+        : done_(false)
+        , alerted_(false)
+        , available_(INITIAL_CURSOR_VALUE)
+        , elapsed_ns_(0)
+        , barrier_(barrier)
+        , sequence_(sequence)
+        , timeout_us_(timeout_us)
+        , thread_(boost::bind(&Waiter::run, this))
+    {
+    }
+
+    ~Waiter()
+    {
+        barrier_->alert();
+        thread_.join();
+    }
+
+    // @return false if the wait has not returned within timeout_ms.
+    bool waitDone(int64_t timeout_ms = 1000)
+    {
+        const int64_t deadline = monotonicNanos() + timeout_ms * 1000 * 1000;
+        while (!done_.load() && monotonicNanos() < deadline) {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+        return done_.load();
+    }
+
+    stdext::atomic<bool>    done_;
+    stdext::atomic<bool>    alerted_;
+    stdext::atomic<int64_t> available_;
+    stdext::atomic<int64_t> elapsed_ns_;
+
+private:
+    void run()
+    {
+        const int64_t start = monotonicNanos();
+        try {
+            available_.store(timeout_us_ == 0 ? barrier_->waitFor(sequence_)
+                    : barrier_->waitFor(sequence_,
+                        stdext::chrono::microseconds(timeout_us_)));
+        }
+        catch(const AlertException& e) {
+            alerted_.store(true);
+        }
+        elapsed_ns_.store(monotonicNanos() - start);
+        done_.store(true);
+    }
+
+    SequenceBarrierPtr barrier_;
+    const int64_t      sequence_;
+    const int64_t      timeout_us_;
+    boost::thread      thread_;
+};
+
+class BlockingStrategyFixture : public ::testing::Test
+{
+public:
+    BlockingStrategyFixture()
+        : ring_buffer(16, kSingleThreadedStrategy, kBlockingStrategy,
+                      TimeConfig())
+        , upstream(INITIAL_CURSOR_VALUE)
+        , upstream_barrier(ring_buffer.newBarrier(DependentSequences()))
+        , downstream_barrier(ring_buffer.newBarrier(
+                    DependentSequences(1, &upstream)))
+    {
+        ring_buffer.setGatingSequences(DependentSequences(1, &upstream));
+    }
+
+    void publish()
+    {
+        ring_buffer.publish(ring_buffer.next());
+    }
+
+    static void settle()
+    {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    }
+
+    RingBuffer<int64_t> ring_buffer;
+    Sequence            upstream;
+    SequenceBarrierPtr  upstream_barrier;
+    SequenceBarrierPtr  downstream_barrier;
+};
+
+TEST_F(BlockingStrategyFixture, testPublishWakesFirstStage)
+{
+    Waiter waiter(upstream_barrier, 0);
+    settle();
+    publish();
+    ASSERT_TRUE(waiter.waitDone());
+    EXPECT_EQ(0, waiter.available_.load());
+}
+
+TEST_F(BlockingStrategyFixture, testUpstreamSignalWakesDependentStage)
+{
+    Waiter waiter(downstream_barrier, 0);
+    publish();
+    settle();
+    EXPECT_FALSE(waiter.done_.load());
+
+    upstream.set(0);
+    ring_buffer.signal(upstream);
+    ASSERT_TRUE(waiter.waitDone());
+    EXPECT_EQ(0, waiter.available_.load());
+}
+
+TEST_F(BlockingStrategyFixture, testPublishDoesNotWakeDependentStage)
+{
+    // parked for as long as the upstream sequence does not move
+    Waiter waiter(downstream_barrier, 0);
+    settle();
+
+    WaitQueue* queue = downstream_barrier->getWaitQueue();
+    stdext::unique_lock<stdext::mutex> ulock(queue->mutex_);
+    boost::thread publisher(boost::bind(&BlockingStrategyFixture::publish, this));
+    // the publish signals the cursor, not the queue of the dependent stage
+    bool woken = queue->condition_.wait_for(ulock,
+            stdext::chrono::milliseconds(100)) == stdext::cv_status::no_timeout;
+    ulock.unlock();
+    publisher.join();
+    EXPECT_FALSE(woken);
+    EXPECT_FALSE(waiter.done_.load());
+}
+
+TEST_F(BlockingStrategyFixture, testAlertUnparksWaiter)
+{
+    Waiter waiter(upstream_barrier, 0);
+    settle();
+    upstream_barrier->alert();
+    ASSERT_TRUE(waiter.waitDone());
+    EXPECT_TRUE(waiter.alerted_.load());
+}
+
+TEST_F(BlockingStrategyFixture, testTimedWaitReturnsOnDeadline)
+{
+    Waiter waiter(downstream_barrier, 0, 50 * 1000);
+    // wake ups of the queue that do not make the sequence available
+    for (int i = 0; i < 20 && !waiter.done_.load(); ++i) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+        ring_buffer.signal(upstream);
+    }
+    ASSERT_TRUE(waiter.waitDone());
+    EXPECT_FALSE(waiter.alerted_.load());
+    EXPECT_EQ(INITIAL_CURSOR_VALUE, waiter.available_.load());
+    EXPECT_LE(50L * 1000 * 1000, waiter.elapsed_ns_.load());
+    EXPECT_GT(150L * 1000 * 1000, waiter.elapsed_ns_.load());
+}
+
+TEST_F(BlockingStrategyFixture, testSignalReachesQueuesLeftOnSequence)
+{
+    Waiter waiter(downstream_barrier, 0);
+    publish();
+    // another barrier on the same upstream sequence comes and goes
+    ring_buffer.newBarrier(DependentSequences(1, &upstream)).reset();
+    settle();
+    EXPECT_FALSE(waiter.done_.load());
+
+    upstream.set(0);
+    ring_buffer.signal(upstream);
+    ASSERT_TRUE(waiter.waitDone());
+    EXPECT_EQ(0, waiter.available_.load());
+}
+
+TEST(BlockingStrategyTest, testBarrierOutlivesRingBuffer)
+{
+    SequenceBarrierPtr barrier;
+    {
+        RingBuffer<int64_t> ring_buffer(16, kSingleThreadedStrategy,
+                                        kBlockingStrategy, TimeConfig());
+        barrier = ring_buffer.newBarrier(DependentSequences());
+    }
+    // unsubscribes from the wait strategy it shares with the ring buffer
+    barrier.reset();
+}
+
+}
+}
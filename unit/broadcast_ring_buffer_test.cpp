@@ -0,0 +1,218 @@
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/broadcast_ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include "utils.h"
+
+namespace disruptor {
+namespace test {
+
+static const size_t BROADCAST_BLOCK_SIZE = 8;
+
+typedef BroadcastDynamicRingBuffer<StubEvent> StubBroadcastBuffer;
+
+TEST(BroadcastDynamicRingBufferTest, testEveryReaderSeesEveryEvent)
+{
+    StubBroadcastBuffer ring_buffer(BROADCAST_BLOCK_SIZE);
+    StubBroadcastBuffer::Reader* first = ring_buffer.addReader();
+    StubBroadcastBuffer::Reader* second = ring_buffer.addReader();
+
+    const int total_event = BROADCAST_BLOCK_SIZE * 3 + 5;
+    for (int i = 0; i < total_event; ++i) {
+        ring_buffer.enqueue(StubEvent(i));
+    }
+    EXPECT_EQ((size_t)total_event, ring_buffer.occupied_approx(first));
+
+    StubEvent received_event;
+    for (int i = 0; i < total_event; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(first, received_event));
+        EXPECT_EQ(i, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(first, received_event));
+    EXPECT_EQ(0UL, ring_buffer.occupied_approx(first));
+    EXPECT_EQ((size_t)total_event, ring_buffer.occupied_approx(second));
+
+    for (int i = 0; i < total_event; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(second, received_event));
+        EXPECT_EQ(i, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(second, received_event));
+}
+
+TEST(BroadcastDynamicRingBufferTest, testBlocksFollowSlowestReader)
+{
+    StubBroadcastBuffer ring_buffer(BROADCAST_BLOCK_SIZE);
+    StubBroadcastBuffer::Reader* fast = ring_buffer.addReader();
+    StubBroadcastBuffer::Reader* slow = ring_buffer.addReader();
+
+    StubEvent received_event;
+    const int total_event = BROADCAST_BLOCK_SIZE * 10;
+    for (int i = 0; i < total_event; ++i) {
+        ring_buffer.enqueue(StubEvent(i));
+        ASSERT_TRUE(ring_buffer.dequeue(fast, received_event));
+    }
+    // the slow reader holds every block back
+    EXPECT_EQ(10UL, ring_buffer.num_blocks());
+
+    while (ring_buffer.dequeue(slow, received_event)) {
+    }
+    for (int i = 0; i < total_event; ++i) {
+        ring_buffer.enqueue(StubEvent(i));
+        ASSERT_TRUE(ring_buffer.dequeue(fast, received_event));
+        ASSERT_TRUE(ring_buffer.dequeue(slow, received_event));
+    }
+    // the tail block and the spare one
+    EXPECT_EQ(2UL, ring_buffer.num_blocks());
+
+    // a removed reader holds nothing back
+    StubBroadcastBuffer::Reader* gone = ring_buffer.addReader();
+    for (int i = 0; i < total_event; ++i) {
+        ring_buffer.enqueue(StubEvent(i));
+    }
+    ring_buffer.removeReader(gone);
+    EXPECT_EQ(2UL, ring_buffer.num_readers());
+    while (ring_buffer.dequeue(fast, received_event)) {
+    }
+    while (ring_buffer.dequeue(slow, received_event)) {
+    }
+    ring_buffer.enqueue(StubEvent(0));
+    EXPECT_EQ(2UL, ring_buffer.num_blocks());
+}
+
+class BroadcastSumHandler : public IEventHandler<StubEvent>
+{
+public:
+    BroadcastSumHandler() : count_(0), out_of_order_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         StubEvent* event)
+    {
+        if (event != NULL && event->value() != count_++) {
+            ++out_of_order_;
+        }
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    int64_t count_;
+    int64_t out_of_order_;
+};
+
+TEST(BroadcastDynamicDisruptorTest, testHandlersSeeWholeStream)
+{
+    const int total_event = 200000;
+    BroadcastSumHandler handlers[3];
+    std::vector<IEventHandler<StubEvent>*> handler_list;
+    for (int i = 0; i < 3; ++i) {
+        handler_list.push_back(&handlers[i]);
+    }
+
+    BroadcastDynamicDisruptor<StubEvent> disruptor(64, kYieldingStrategy,
+                                                   handler_list, NULL);
+    for (int i = 0; i < total_event; ++i) {
+        disruptor.publishEvent(StubEvent(i));
+    }
+    while (disruptor.occupiedCapacity() != 0) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(total_event, handlers[i].count_);
+        EXPECT_EQ(0, handlers[i].out_of_order_);
+    }
+}
+
+TEST(BroadcastDynamicRingBufferTest, testReaderOnlySeesUpstreamCommits)
+{
+    StubBroadcastBuffer ring_buffer(BROADCAST_BLOCK_SIZE);
+    StubBroadcastBuffer::Reader* first = ring_buffer.addReader();
+    StubBroadcastBuffer::Reader* second = ring_buffer.addReader(
+            std::vector<StubBroadcastBuffer::Reader*>(1, first));
+
+    for (int i = 0; i < 20; ++i) {
+        ring_buffer.enqueue(StubEvent(i));
+    }
+    EXPECT_EQ(19, ring_buffer.getAvailableSequence(first));
+    EXPECT_EQ(INITIAL_CURSOR_VALUE, ring_buffer.getAvailableSequence(second));
+
+    StubEvent received_event;
+    EXPECT_FALSE(ring_buffer.dequeue(second, received_event));
+    for (int i = 0; i < 10; ++i) {
+        // enriched in place for the next stage
+        ring_buffer.get(first, i)->set_value(i * 2);
+    }
+    ring_buffer.commit(first, 9);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(second, received_event));
+        EXPECT_EQ(i * 2, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(second, received_event));
+}
+
+class StageHandler : public IEventHandler<StubEvent>
+{
+public:
+    explicit StageHandler(int stage) : stage_(stage), count_(0), bad_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         StubEvent* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        // every upstream stage has added one
+        if (event->value() != sequence + stage_) {
+            ++bad_;
+        }
+        event->set_value(event->value() + 1);
+        ++count_;
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    int     stage_;
+    int64_t count_;
+    int64_t bad_;
+};
+
+TEST(DynamicPipelineTest, testStagesSeeUpstreamUpdates)
+{
+    const int total_event = 200000;
+    StageHandler decode(0), enrich(1), journal(2);
+
+    DynamicPipeline<StubEvent> pipeline(64, kYieldingStrategy, NULL);
+    pipeline.addStage(&decode);
+    pipeline.then(&enrich);
+    pipeline.then(&journal);
+    pipeline.start();
+    EXPECT_THROW(pipeline.then(&journal), std::runtime_error);
+
+    for (int i = 0; i < total_event; ++i) {
+        pipeline.publishEvent(StubEvent(i));
+    }
+    while (pipeline.occupiedCapacity() != 0) {
+        boost::this_thread::yield();
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(total_event, decode.count_);
+    EXPECT_EQ(total_event, journal.count_);
+    EXPECT_EQ(0, decode.bad_ + enrich.bad_ + journal.bad_);
+}
+
+}
+}
@@ -0,0 +1,160 @@
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <disruptor/cooperative_executor.h>
+
+#include <gtest/gtest.h>
+
+#include "utils.h"
+
+static const int BUFFER_SIZE = 64;
+static const int NUM_RINGS = 32;
+
+namespace disruptor {
+namespace test {
+
+class CountingHandler : public IEventHandler<StubEvent>
+{
+public:
+    CountingHandler() : count_(0), sum_(0), started_(0), shutdown_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         StubEvent* event)
+    {
+        sum_ += event->value();
+        count_.fetch_add(1);
+    }
+
+    virtual void onStart() { ++started_; }
+
+    virtual void onShutdown() { ++shutdown_; }
+
+    boost::atomic<int64_t> count_;
+    int64_t sum_;
+    int started_;
+    int shutdown_;
+};
+
+struct Session
+{
+    Session()
+        : ring_buffer(BUFFER_SIZE, kSingleThreadedStrategy, kBusySpinStrategy,
+                      TimeConfig())
+        , processor(&ring_buffer,
+                    ring_buffer.newBarrier(DependentSequences()),
+                    &handler,
+                    NULL)
+        , task(NULL)
+    {
+        ring_buffer.setGatingSequences(
+                DependentSequences(1, processor.getSequence()));
+    }
+
+    RingBuffer<StubEvent> ring_buffer;
+    CountingHandler handler;
+    CooperativeEventProcessor<StubEvent> processor;
+    CooperativeExecutor::Task* task;
+};
+
+TEST(CooperativeExecutorTest, testManyRingsOnFewThreads)
+{
+    const int iterations = BUFFER_SIZE * 10;
+    std::vector< boost::shared_ptr<Session> > sessions;
+    CooperativeExecutor executor(2, 16, 10);
+
+    for (int i = 0; i < NUM_RINGS; ++i) {
+        sessions.push_back(boost::make_shared<Session>());
+        sessions.back()->task = executor.add(&sessions.back()->processor);
+    }
+    executor.start();
+
+    for (int j = 0; j < iterations; ++j) {
+        for (int i = 0; i < NUM_RINGS; ++i) {
+            Session& session = *sessions[i];
+            int64_t sequence = session.ring_buffer.next();
+            session.ring_buffer.get(sequence)->set_value(j);
+            session.ring_buffer.publish(sequence);
+            executor.notify(session.task);
+        }
+        if (j % BUFFER_SIZE == 0) {
+            // let every task park now and then
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(1));
+        }
+    }
+
+    for (int i = 0; i < NUM_RINGS; ++i) {
+        while (sessions[i]->processor.getSequence()->get() < iterations - 1) {
+            boost::this_thread::yield();
+        }
+    }
+    executor.stop();
+
+    for (int i = 0; i < NUM_RINGS; ++i) {
+        const CountingHandler& handler = sessions[i]->handler;
+        EXPECT_EQ(iterations, handler.count_.load());
+        EXPECT_EQ((int64_t)iterations * (iterations - 1) / 2, handler.sum_);
+        EXPECT_EQ(1, handler.started_);
+        EXPECT_EQ(1, handler.shutdown_);
+    }
+}
+
+TEST(CooperativeExecutorTest, testNoWakeupLostWhenParkingOnFirstDryPoll)
+{
+    // every dry poll parks, so most publishes race with a task being parked
+    const int iterations = 20000;
+    const int num_sessions = 4;
+    std::vector< boost::shared_ptr<Session> > sessions;
+    CooperativeExecutor executor(2, 16, 1);
+
+    for (int i = 0; i < num_sessions; ++i) {
+        sessions.push_back(boost::make_shared<Session>());
+        sessions.back()->task = executor.add(&sessions.back()->processor);
+    }
+    executor.start();
+
+    for (int j = 0; j < iterations; ++j) {
+        for (int i = 0; i < num_sessions; ++i) {
+            Session& session = *sessions[i];
+            int64_t sequence = session.ring_buffer.next();
+            session.ring_buffer.get(sequence)->set_value(j);
+            session.ring_buffer.publish(sequence);
+            executor.notify(session.task);
+        }
+        // a lost wakeup leaves the event unconsumed for good
+        for (int i = 0; i < num_sessions; ++i) {
+            const boost::chrono::steady_clock::time_point deadline =
+                boost::chrono::steady_clock::now() + boost::chrono::seconds(5);
+            while (sessions[i]->processor.getSequence()->get() < j
+                    && boost::chrono::steady_clock::now() < deadline) {
+                boost::this_thread::yield();
+            }
+            ASSERT_EQ(j, sessions[i]->processor.getSequence()->get());
+        }
+    }
+    executor.stop();
+
+    for (int i = 0; i < num_sessions; ++i) {
+        EXPECT_EQ(iterations, sessions[i]->handler.count_.load());
+    }
+}
+
+TEST(CooperativeExecutorTest, testPollIsBoundedByMaxBatch)
+{
+    Session session;
+    for (int i = 0; i < 10; ++i) {
+        session.ring_buffer.publish(session.ring_buffer.next());
+    }
+
+    EXPECT_EQ(4, session.processor.poll(4));
+    EXPECT_EQ(3, session.processor.getSequence()->get());
+    EXPECT_EQ(6, session.processor.poll(100));
+    EXPECT_EQ(0, session.processor.poll(100));
+    EXPECT_EQ(9, session.processor.getSequence()->get());
+}
+
+}
+}
@@ -0,0 +1,54 @@
+#include <string>
+#include <vector>
+
+#include <disruptor/crc32c.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+TEST(Crc32cTest, testKnownValues)
+{
+    const std::string check("123456789");
+    EXPECT_EQ(0xE3069283U, crc32c(check.data(), check.size()));
+    EXPECT_EQ(0U, crc32c(check.data(), 0));
+
+    // 32 bytes of zeros, from RFC 3720
+    const std::vector<unsigned char> zeros(32, 0);
+    EXPECT_EQ(0x8A9136AAU, crc32c(&zeros[0], zeros.size()));
+}
+
+TEST(Crc32cTest, testChainedEqualsWhole)
+{
+    std::vector<unsigned char> data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+
+    const uint32_t whole = crc32c(&data[0], data.size());
+    uint32_t chained = crc32c(&data[0], 3);
+    chained = crc32c(&data[3], 500, chained);
+    chained = crc32c(&data[503], data.size() - 503, chained);
+    EXPECT_EQ(whole, chained);
+}
+
+TEST(Crc32cTest, testHardwareMatchesSoftware)
+{
+    if (!hasHardwareCrc32c()) {
+        return;
+    }
+
+    std::vector<unsigned char> data(4099);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<unsigned char>(i ^ (i >> 8));
+    }
+
+    for (size_t length = 0; length < data.size(); length += 97) {
+        EXPECT_EQ(detail::crc32cSoftware(~0U, &data[1], length),
+                  detail::crc32cHardware(~0U, &data[1], length));
+    }
+}
+
+}
+}
@@ -0,0 +1,78 @@
+#include <limits>
+#include <vector>
+
+#include <disruptor/delta_codec.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+struct Tick
+{
+    int64_t sequence;
+    int64_t timestamp;
+    int64_t price;
+    int32_t quantity;
+    char    side;
+};
+
+TEST(DeltaCodecTest, testRoundTrip)
+{
+    std::vector<Tick> ticks(1000);
+    memset(&ticks[0], 0, ticks.size() * sizeof(Tick));
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        ticks[i].sequence = 1000000 + i;
+        ticks[i].timestamp = 1500000000000LL + i * 37;
+        ticks[i].price = 10000 + (i % 7) - 3;
+        ticks[i].quantity = -(int32_t)i;
+        ticks[i].side = i % 2 ? 'B' : 'S';
+    }
+
+    std::vector<unsigned char> encoded;
+    DeltaCodec<Tick>::encode(&ticks[0], ticks.size(), encoded);
+    EXPECT_LT(encoded.size(), ticks.size() * sizeof(Tick) / 2);
+
+    std::vector<Tick> decoded;
+    EXPECT_EQ(encoded.size(),
+              DeltaCodec<Tick>::decode(&encoded[0], encoded.size(), decoded));
+    ASSERT_EQ(ticks.size(), decoded.size());
+    EXPECT_EQ(0, memcmp(&ticks[0], &decoded[0], ticks.size() * sizeof(Tick)));
+}
+
+TEST(DeltaCodecTest, testBatchesAreSelfContained)
+{
+    std::vector<int64_t> values;
+    values.push_back(std::numeric_limits<int64_t>::min());
+    values.push_back(std::numeric_limits<int64_t>::max());
+    values.push_back(0);
+    values.push_back(-1);
+
+    std::vector<unsigned char> encoded;
+    DeltaCodec<int64_t>::encode(&values[0], 2, encoded);
+    const size_t first_batch = encoded.size();
+    DeltaCodec<int64_t>::encode(&values[2], 2, encoded);
+
+    std::vector<int64_t> decoded;
+    size_t consumed = DeltaCodec<int64_t>::decode(&encoded[0], encoded.size(),
+                                                  decoded);
+    EXPECT_EQ(first_batch, consumed);
+    DeltaCodec<int64_t>::decode(&encoded[consumed], encoded.size() - consumed,
+                                decoded);
+    EXPECT_EQ(values, decoded);
+}
+
+TEST(DeltaCodecTest, testTruncatedBatchIsRejected)
+{
+    std::vector<int64_t> values(100, 1LL << 40);
+    std::vector<unsigned char> encoded;
+    DeltaCodec<int64_t>::encode(&values[0], values.size(), encoded);
+
+    std::vector<int64_t> decoded;
+    EXPECT_EQ(0U, DeltaCodec<int64_t>::decode(&encoded[0], encoded.size() - 1,
+                                              decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+}
+}
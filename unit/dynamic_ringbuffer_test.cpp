@@ -83,6 +83,91 @@ TEST_F(DynamicRingBufferFixture, testEnqueueAndDequeueWithMoreThanOneBlock)
     EXPECT_EQ(0UL, ring_buffer.occupied_approx());
 }
 
+TEST_F(DynamicRingBufferFixture, testReserveAllocatesBlocksUpFront)
+{
+    ring_buffer.reserve(BUFFER_SIZE * 3 + 1);
+    EXPECT_EQ(4UL, ring_buffer.num_blocks());
+    EXPECT_EQ(BUFFER_SIZE * 4, ring_buffer.available_approx());
+    EXPECT_TRUE(ring_buffer.preFault());
+
+    // reserved blocks are used before any new one gets allocated
+    unsigned total_event = BUFFER_SIZE * 4;
+    for (unsigned i = 0; i < total_event; ++i) {
+        ASSERT_NO_THROW(ring_buffer.enqueue(StubEvent(i)));
+    }
+    EXPECT_EQ(4UL, ring_buffer.num_blocks());
+
+    StubEvent received_event;
+    for (unsigned i = 0; i < total_event; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(received_event));
+        EXPECT_EQ((int)i, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(received_event));
+}
+
+TEST(DynamicRingBufferGrowthTest, testBlocksDoubleUpToMaxSize)
+{
+    DynamicRingBuffer<StubEvent> ring_buffer(BUFFER_SIZE,
+            disruptor::kSingleThreadedStrategy,
+            disruptor::kSleepingStrategy,
+            TimeConfig(),
+            BUFFER_SIZE * 4);
+
+    // 8 + 16 + 32 + 32
+    unsigned total_event = BUFFER_SIZE * 11;
+    for (unsigned i = 0; i < total_event; ++i) {
+        ASSERT_NO_THROW(ring_buffer.enqueue(StubEvent(i)));
+    }
+    EXPECT_EQ(4UL, ring_buffer.num_blocks());
+    EXPECT_EQ(BUFFER_SIZE * 11, ring_buffer.capacity());
+    EXPECT_EQ(0UL, ring_buffer.available_approx());
+
+    StubEvent received_event;
+    for (unsigned i = 0; i < total_event; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(received_event));
+        EXPECT_EQ((int)i, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(received_event));
+}
+
+TEST(DynamicRingBufferGrowthTest, testEnqueueBulkSizesBlockForTheRest)
+{
+    DynamicRingBuffer<StubEvent> ring_buffer(BUFFER_SIZE,
+            disruptor::kSingleThreadedStrategy,
+            disruptor::kSleepingStrategy,
+            TimeConfig(),
+            BUFFER_SIZE * 64);
+
+    std::vector<StubEvent> events;
+    for (unsigned i = 0; i < BUFFER_SIZE * 20; ++i) {
+        events.push_back(StubEvent(i));
+    }
+    ring_buffer.enqueue(events[0]);
+    ring_buffer.enqueue_bulk(events.begin() + 1, events.end());
+
+    // the first block then one block big enough for the rest
+    EXPECT_EQ(2UL, ring_buffer.num_blocks());
+    EXPECT_EQ(events.size(), ring_buffer.occupied_approx());
+
+    StubEvent received_event;
+    for (unsigned i = 0; i < events.size(); ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(received_event));
+        EXPECT_EQ((int)i, received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(received_event));
+
+    // the big block has room for both ranges now it is drained
+    ring_buffer.enqueue_bulk(events.begin(), events.begin() + 3);
+    ring_buffer.enqueue_bulk(events.begin(), events.end());
+    EXPECT_EQ(2UL, ring_buffer.num_blocks());
+    EXPECT_EQ(events.size() + 3, ring_buffer.occupied_approx());
+    for (unsigned i = 0; i < events.size() + 3; ++i) {
+        ASSERT_TRUE(ring_buffer.dequeue(received_event));
+        EXPECT_EQ((int)(i < 3 ? i : i - 3), received_event.value());
+    }
+    EXPECT_FALSE(ring_buffer.dequeue(received_event));
+}
+
 std::vector<StubEvent> consume(DynamicRingBuffer<StubEvent>& ring_buffer,
         unsigned expected_total,
         unsigned sleep_us,
@@ -141,6 +226,31 @@ TEST_F(DynamicRingBufferFixture, testEnqueueAndDequeueInSeperateThread)
     }
 }
 
+TEST_F(DynamicRingBufferFixture, testEnqueueBulkInSeperateThread)
+{
+    unsigned total_event = 100000;
+
+    boost::packaged_task< std::vector<StubEvent> > consumer(
+            boost::bind(&consume, boost::ref(ring_buffer), total_event, 0, 2000));
+    boost::unique_future<std::vector<StubEvent> > future = consumer.get_future();
+    boost::thread thread(boost::ref(consumer));
+
+    std::vector<StubEvent> expected;
+    for (unsigned i = 0; i < total_event; ++i) {
+        expected.push_back(StubEvent(i));
+    }
+    for (unsigned i = 0; i < total_event; i += 100) {
+        ring_buffer.enqueue_bulk(expected.begin() + i, expected.begin() + i + 100);
+    }
+
+    std::vector<StubEvent> results = future.get();
+
+    ASSERT_EQ(total_event, results.size());
+    for (unsigned i = 0; i < total_event; ++i) {
+        ASSERT_EQ(expected[i].value(), results[i].value());
+    }
+}
+
 // minimum frequency is 1HZ
 unsigned freqToMicrosecondInterval(unsigned freq, unsigned order)
 {
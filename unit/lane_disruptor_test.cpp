@@ -0,0 +1,100 @@
+#include <stdexcept>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/lane_disruptor.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+struct LaneEvent
+{
+    int64_t producer;
+    int64_t value;
+};
+
+class LaneOrderHandler : public IEventHandler<LaneEvent>
+{
+public:
+    explicit LaneOrderHandler(size_t producers)
+        : next_(producers, 0)
+        , out_of_order_(0)
+    {
+    }
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         LaneEvent* event)
+    {
+        if (event != NULL && event->value != next_[event->producer]++) {
+            ++out_of_order_;
+        }
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    std::vector<int64_t> next_;
+    int64_t              out_of_order_;
+};
+
+class LaneTranslator : public IEventTranslator<LaneEvent>
+{
+public:
+    LaneTranslator(int64_t producer) : producer_(producer), value_(0) {}
+
+    virtual LaneEvent* translateTo(const int64_t& sequence, LaneEvent* event)
+    {
+        event->producer = producer_;
+        event->value = value_++;
+        return event;
+    }
+
+private:
+    int64_t producer_;
+    int64_t value_;
+};
+
+static const int64_t LANE_EVENTS = 100000;
+
+static void produce(LaneDisruptor<LaneEvent>* disruptor)
+{
+    ProducerToken<LaneEvent>* token = disruptor->registerProducer();
+    LaneTranslator translator(token->index());
+    for (int64_t i = 0; i < LANE_EVENTS; ++i) {
+        disruptor->publishEvent(token, &translator);
+    }
+}
+
+TEST(LaneDisruptorTest, testKeepsOrderPerProducer)
+{
+    const size_t producers = 3;
+    LaneOrderHandler handler(producers);
+    LaneDisruptor<LaneEvent> disruptor(64, producers, kYieldingStrategy,
+                                       &handler, NULL);
+
+    boost::thread_group threads;
+    for (size_t i = 0; i < producers; ++i) {
+        threads.create_thread(boost::bind(&produce, &disruptor));
+    }
+    threads.join_all();
+    while (disruptor.processor().getSequence()->get()
+            < (int64_t)producers * LANE_EVENTS - 1) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+
+    EXPECT_EQ(0, handler.out_of_order_);
+    for (size_t i = 0; i < producers; ++i) {
+        EXPECT_EQ(LANE_EVENTS, handler.next_[i]);
+    }
+    EXPECT_THROW(disruptor.registerProducer(), std::runtime_error);
+}
+
+}
+}
@@ -0,0 +1,113 @@
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+#include <disruptor/latency_histogram.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+TEST(LatencyHistogramTest, testPercentilesWithinBucketError)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.percentile(0.99));
+
+    for (int64_t i = 1; i <= 100000; ++i) {
+        histogram.record(i);
+    }
+    EXPECT_EQ(100000, histogram.count());
+    EXPECT_EQ(100000, histogram.max());
+    EXPECT_DOUBLE_EQ(50000.5, histogram.mean());
+
+    const double fractions[] = { 0.5, 0.9, 0.99, 0.999 };
+    for (int i = 0; i < 4; ++i) {
+        const double exact = fractions[i] * 100000;
+        EXPECT_GE(histogram.percentile(fractions[i]), exact);
+        EXPECT_LE(histogram.percentile(fractions[i]), exact * 1.125);
+    }
+    EXPECT_EQ(100000, histogram.percentile(1.0));
+
+    // small values are exact
+    LatencyHistogram small;
+    small.record(3);
+    small.record(5);
+    EXPECT_EQ(3, small.percentile(0.5));
+    EXPECT_EQ(5, small.percentile(0.51));
+
+    small.merge(histogram);
+    EXPECT_EQ(100002, small.count());
+    EXPECT_EQ(100000, small.max());
+}
+
+class ClaimCountingHandler : public IEventHandler<int64_t>
+{
+public:
+    ClaimCountingHandler() : count_(0) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event != NULL) {
+            ++count_;
+        }
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    int64_t count_;
+};
+
+class SequenceTranslator : public IEventTranslator<int64_t>
+{
+public:
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = sequence;
+        return event;
+    }
+};
+
+static const int64_t FAIR_EVENTS = 20000;
+
+static void publishFairly(Disruptor<int64_t>* disruptor,
+                          LatencyHistogram* latency)
+{
+    SequenceTranslator translator;
+    for (int64_t i = 0; i < FAIR_EVENTS; ++i) {
+        disruptor->publishEvent(&translator, latency);
+    }
+}
+
+TEST(FairMultiThreadedStrategyTest, testEveryPublisherGetsThrough)
+{
+    const int producers = 4;
+    ClaimCountingHandler handler;
+    Disruptor<int64_t> disruptor(64, kMultiThreadedFairStrategy,
+                                 kYieldingStrategy, &handler, NULL);
+
+    LatencyHistogram latencies[producers];
+    boost::thread_group threads;
+    for (int i = 0; i < producers; ++i) {
+        threads.create_thread(boost::bind(&publishFairly, &disruptor,
+                                          &latencies[i]));
+    }
+    threads.join_all();
+    while (disruptor.processor().getSequence()->get()
+            < producers * FAIR_EVENTS - 1) {
+        boost::this_thread::yield();
+    }
+    disruptor.stop();
+
+    EXPECT_EQ(producers * FAIR_EVENTS, handler.count_);
+    for (int i = 0; i < producers; ++i) {
+        EXPECT_EQ(FAIR_EVENTS, latencies[i].count());
+    }
+}
+
+}
+}
@@ -0,0 +1,150 @@
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/mpmc_queue.h>
+
+#include <gtest/gtest.h>
+
+static const size_t QUEUE_SIZE = 8;
+
+namespace disruptor {
+namespace test {
+
+class MpmcQueueFixture : public ::testing::Test
+{
+protected:
+    MpmcQueueFixture()
+        : queue(QUEUE_SIZE - 1)
+    {
+    }
+
+    MpmcQueue<int64_t> queue;
+};
+
+TEST_F(MpmcQueueFixture, testCapacityIsRoundedUp)
+{
+    EXPECT_EQ(QUEUE_SIZE, queue.capacity());
+    EXPECT_EQ(0UL, queue.size_approx());
+}
+
+TEST(MpmcQueueTest, testSmallestCapacityIsTwo)
+{
+    for (size_t capacity = 0; capacity <= 1; ++capacity) {
+        MpmcQueue<int64_t> queue(capacity);
+        EXPECT_EQ(2UL, queue.capacity());
+
+        // a second push must not overwrite the first value
+        EXPECT_TRUE(queue.try_push(1));
+        EXPECT_TRUE(queue.try_push(2));
+        EXPECT_FALSE(queue.try_push(3));
+        EXPECT_EQ(1, queue.pop());
+        EXPECT_EQ(2, queue.pop());
+        int64_t value = 0;
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+}
+
+TEST_F(MpmcQueueFixture, testPushAndPop)
+{
+    int64_t value = 0;
+    EXPECT_FALSE(queue.try_pop(value));
+
+    for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(42));
+    EXPECT_EQ(QUEUE_SIZE, queue.size_approx());
+
+    for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ((int64_t)i, value);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+
+    // second lap
+    EXPECT_TRUE(queue.try_push(42));
+    EXPECT_EQ(42, queue.pop());
+}
+
+TEST_F(MpmcQueueFixture, testBulkPushAndPop)
+{
+    int64_t values[QUEUE_SIZE * 2];
+    for (size_t i = 0; i < QUEUE_SIZE * 2; ++i) {
+        values[i] = i;
+    }
+
+    EXPECT_EQ(3UL, queue.try_push(values, 3));
+    EXPECT_EQ(QUEUE_SIZE - 3, queue.try_push(values + 3, QUEUE_SIZE));
+    EXPECT_EQ(0UL, queue.try_push(values, 1));
+
+    int64_t received[QUEUE_SIZE * 2];
+    EXPECT_EQ(QUEUE_SIZE, queue.try_pop(received, QUEUE_SIZE * 2));
+    for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+        EXPECT_EQ((int64_t)i, received[i]);
+    }
+    EXPECT_EQ(0UL, queue.try_pop(received, 1));
+}
+
+void pushAll(MpmcQueue<int64_t>* queue, const int64_t* values, size_t count)
+{
+    queue->push(values, count);
+}
+
+TEST_F(MpmcQueueFixture, testBlockingBulkPopWaitsForEveryValue)
+{
+    const size_t count = QUEUE_SIZE * 3;
+    int64_t values[count];
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = i;
+    }
+
+    // more values than the queue holds, popped as they are pushed
+    boost::thread producer(boost::bind(&pushAll, &queue, values, count));
+    int64_t received[count];
+    queue.pop(received, count);
+    producer.join();
+
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ((int64_t)i, received[i]);
+    }
+    EXPECT_EQ(0UL, queue.size_approx());
+}
+
+void produce(MpmcQueue<int64_t>* queue, int64_t first, int64_t count)
+{
+    for (int64_t i = first; i < first + count; ++i) {
+        queue->push(i);
+    }
+}
+
+void consume(MpmcQueue<int64_t>* queue, int64_t count,
+             boost::atomic<int64_t>* sum)
+{
+    int64_t local_sum = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        local_sum += queue->pop();
+    }
+    sum->fetch_add(local_sum);
+}
+
+TEST_F(MpmcQueueFixture, testMultiProducerMultiConsumer)
+{
+    const int num_threads = 3;
+    const int64_t per_thread = 100000;
+    boost::atomic<int64_t> sum(0);
+    boost::thread_group threads;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.create_thread(boost::bind(&produce, &queue, i * per_thread, per_thread));
+        threads.create_thread(boost::bind(&consume, &queue, per_thread, &sum));
+    }
+    threads.join_all();
+
+    const int64_t total = num_threads * per_thread;
+    EXPECT_EQ(total * (total - 1) / 2, sum.load());
+    EXPECT_EQ(0UL, queue.size_approx());
+}
+
+}
+}
@@ -0,0 +1,148 @@
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <vector>
+
+#include <boost/bind.hpp>
+
+#include <disruptor/multicast_egress.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+// The event is the size of its datagram.
+inline size_t encodeSize(const int64_t& size, char* buffer, size_t capacity)
+{
+    memset(buffer, 'x', std::min<size_t>(size, capacity));
+    return size;
+}
+
+// Sends to a unicast loopback receiver, which the handler does not tell from
+// a group, so the datagrams can be read back.
+class MulticastEgressFixture : public ::testing::Test
+{
+protected:
+    MulticastEgressFixture()
+        : receiver_(::socket(AF_INET, SOCK_DGRAM, 0))
+        , config_("127.0.0.1", 0)
+    {
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        struct timeval timeout = { 0, 100 * 1000 };
+        if (bind(receiver_, (struct sockaddr*)&address, sizeof(address)) != 0
+                || getsockname(receiver_, (struct sockaddr*)&address,
+                               &length) != 0
+                || setsockopt(receiver_, SOL_SOCKET, SO_RCVTIMEO,
+                              &timeout, sizeof(timeout)) != 0) {
+            ADD_FAILURE() << "receiver: " << strerror(errno);
+        }
+        config_.port_ = ntohs(address.sin_port);
+        config_.interface_ = "127.0.0.1";
+        config_.max_batch_ = 4;
+        config_.max_datagram_ = 64;
+    }
+
+    ~MulticastEgressFixture()
+    {
+        ::close(receiver_);
+    }
+
+    void send(MulticastEgressHandler<int64_t>& handler,
+              int64_t size,
+              bool end_of_batch)
+    {
+        handler.onEvent(0, 1, end_of_batch, &size);
+    }
+
+    // Sizes of the datagrams received so far.
+    std::vector<int64_t> received()
+    {
+        std::vector<int64_t> sizes;
+        char buffer[1024];
+        ssize_t size;
+        while ((size = recv(receiver_, buffer, sizeof(buffer), 0)) >= 0) {
+            sizes.push_back(size);
+        }
+        return sizes;
+    }
+
+    int             receiver_;
+    MulticastConfig config_;
+};
+
+TEST_F(MulticastEgressFixture, testSendsAtMaxBatchAndEndOfBatch)
+{
+    MulticastEgressHandler<int64_t> handler(config_,
+            boost::bind(&encodeSize, _1, _2, _3));
+    handler.onStart();
+
+    for (int i = 1; i <= 10; ++i) {
+        send(handler, i, i == 10);
+    }
+    // 4 + 4 on max_batch, the last 2 on the end of the batch
+    EXPECT_EQ(3, handler.syscalls());
+    EXPECT_EQ(10, handler.packets());
+
+    send(handler, 20, true);
+    EXPECT_EQ(4, handler.syscalls());
+    handler.onShutdown();
+
+    std::vector<int64_t> sizes = received();
+    ASSERT_EQ(11UL, sizes.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i + 1, sizes[i]);
+    }
+    EXPECT_EQ(20, sizes[10]);
+    EXPECT_EQ(0, handler.errors());
+}
+
+TEST_F(MulticastEgressFixture, testFlushesOnIdle)
+{
+    MulticastEgressHandler<int64_t> handler(config_,
+            boost::bind(&encodeSize, _1, _2, _3));
+    handler.onStart();
+
+    send(handler, 8, false);
+    send(handler, 8, false);
+    EXPECT_EQ(0, handler.syscalls());
+
+    handler.onEvent(0, 0, false, NULL);
+    EXPECT_EQ(1, handler.syscalls());
+    EXPECT_EQ(2, handler.packets());
+    EXPECT_EQ(2UL, received().size());
+    handler.onShutdown();
+}
+
+TEST_F(MulticastEgressFixture, testSkipsEmptyAndDropsOversizedDatagrams)
+{
+    MulticastEgressHandler<int64_t> handler(config_,
+            boost::bind(&encodeSize, _1, _2, _3));
+    handler.onStart();
+
+    send(handler, 0, false);
+    send(handler, 16, false);
+    // would read past the 64 bytes of its buffer
+    send(handler, 65, false);
+    send(handler, 64, true);
+    handler.onShutdown();
+
+    EXPECT_EQ(1, handler.syscalls());
+    EXPECT_EQ(2, handler.packets());
+    EXPECT_EQ(1, handler.errors());
+    std::vector<int64_t> sizes = received();
+    ASSERT_EQ(2UL, sizes.size());
+    EXPECT_EQ(16, sizes[0]);
+    EXPECT_EQ(64, sizes[1]);
+}
+
+}
+}
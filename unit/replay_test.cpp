@@ -0,0 +1,154 @@
+#include <map>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <disruptor/replay.h>
+
+#include <gtest/gtest.h>
+
+static const int NUM_SHARDS = 3;
+static const int SHARD_RING_SIZE = 8192;
+static const size_t SEGMENT_EVENTS = 64;
+
+namespace disruptor {
+namespace test {
+
+struct RecordedEvent
+{
+    uint64_t key;
+    int64_t  recorded;
+};
+
+inline uint64_t recordedKey(const RecordedEvent& event)
+{
+    return event.key;
+}
+
+// Shard rings large enough to hold a few replays without a consumer, so that
+// the events can be read back from them.
+class ReplayFixture : public ::testing::Test
+{
+protected:
+    ReplayFixture()
+        : unread(INITIAL_CURSOR_VALUE)
+    {
+        for (int i = 0; i < NUM_SHARDS; ++i) {
+            rings.push_back(boost::make_shared< RingBuffer<RecordedEvent> >(
+                        SHARD_RING_SIZE, kSingleThreadedStrategy,
+                        kYieldingStrategy, TimeConfig()));
+            rings.back()->setGatingSequences(DependentSequences(1, &unread));
+            shards.push_back(rings.back().get());
+        }
+    }
+
+    // Record events with a few keys, in segments of SEGMENT_EVENTS.
+    void record(size_t num_segments)
+    {
+        journal.resize(num_segments * SEGMENT_EVENTS);
+        for (size_t i = 0; i < journal.size(); ++i) {
+            journal[i].key = (i * 7) % 13;
+            journal[i].recorded = i;
+        }
+        segments.clear();
+        for (size_t i = 0; i < num_segments; ++i) {
+            const RecordedEvent* events = &journal[i * SEGMENT_EVENTS];
+            uint32_t checksum =
+                crc32c(events, SEGMENT_EVENTS * sizeof(RecordedEvent));
+            segments.push_back(ReplaySegment<RecordedEvent>(events,
+                        SEGMENT_EVENTS, checksum));
+        }
+    }
+
+    // Check the events of a shard are those of its keys, in recorded order.
+    //
+    // @return number of events read.
+    int64_t readBack(size_t shard, int64_t first, int64_t last)
+    {
+        std::map<uint64_t, int64_t> last_recorded;
+        for (int64_t sequence = first; sequence <= last; ++sequence) {
+            const RecordedEvent& event = *rings[shard]->get(sequence);
+            EXPECT_EQ(shard, event.key % NUM_SHARDS);
+            std::map<uint64_t, int64_t>::iterator it =
+                last_recorded.find(event.key);
+            if (it != last_recorded.end()) {
+                EXPECT_LT(it->second, event.recorded);
+            }
+            last_recorded[event.key] = event.recorded;
+        }
+        return last - first + 1;
+    }
+
+    Sequence                                                  unread;
+    std::vector< boost::shared_ptr< RingBuffer<RecordedEvent> > > rings;
+    std::vector<RingBuffer<RecordedEvent>*>                   shards;
+    std::vector<RecordedEvent>                                journal;
+    std::vector< ReplaySegment<RecordedEvent> >               segments;
+};
+
+TEST_F(ReplayFixture, testReplaysEveryEventInKeyOrder)
+{
+    record(40);
+    ShardedReplayer<RecordedEvent> replayer(shards,
+            boost::bind(&recordedKey, _1), 4, 4);
+
+    // the second replay reuses the routing buffers of the first one
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<int64_t> first(NUM_SHARDS);
+        for (size_t i = 0; i < shards.size(); ++i) {
+            first[i] = shards[i]->getCursor() + 1;
+        }
+        EXPECT_EQ((int64_t)journal.size(), replayer.replay(segments));
+        EXPECT_EQ(INITIAL_CURSOR_VALUE, replayer.corruptedSegment());
+
+        int64_t total = 0;
+        for (size_t i = 0; i < shards.size(); ++i) {
+            EXPECT_EQ(39, replayer.segmentsReplayed(i));
+            int64_t read = readBack(i, first[i], shards[i]->getCursor());
+            EXPECT_EQ(replayer.replayed(i), read);
+            total += read;
+        }
+        EXPECT_EQ((int64_t)journal.size(), total);
+    }
+}
+
+TEST_F(ReplayFixture, testSingleSegmentWindow)
+{
+    record(10);
+    ShardedReplayer<RecordedEvent> replayer(shards,
+            boost::bind(&recordedKey, _1), 2, 1);
+
+    EXPECT_EQ((int64_t)journal.size(), replayer.replay(segments));
+    int64_t total = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        total += readBack(i, 0, shards[i]->getCursor());
+    }
+    EXPECT_EQ((int64_t)journal.size(), total);
+}
+
+TEST_F(ReplayFixture, testStopsBeforeCorruptedSegment)
+{
+    record(20);
+    // a torn write in segment 12
+    journal[12 * SEGMENT_EVENTS + 5].recorded = -1;
+    ShardedReplayer<RecordedEvent> replayer(shards,
+            boost::bind(&recordedKey, _1), 4, 4);
+
+    EXPECT_EQ(12 * (int64_t)SEGMENT_EVENTS, replayer.replay(segments));
+    EXPECT_EQ(12, replayer.corruptedSegment());
+
+    int64_t total = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        EXPECT_EQ(11, replayer.segmentsReplayed(i));
+        total += readBack(i, 0, shards[i]->getCursor());
+    }
+    EXPECT_EQ(12 * (int64_t)SEGMENT_EVENTS, total);
+
+    // replayed in full once the segment is fixed
+    journal[12 * SEGMENT_EVENTS + 5].recorded = 12 * SEGMENT_EVENTS + 5;
+    EXPECT_EQ((int64_t)journal.size(), replayer.replay(segments));
+    EXPECT_EQ(INITIAL_CURSOR_VALUE, replayer.corruptedSegment());
+}
+
+}
+}
@@ -0,0 +1,249 @@
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <disruptor/request_reply.h>
+
+#include <gtest/gtest.h>
+
+static const int REQUEST_RING_SIZE = 64;
+static const int NUM_CLIENTS = 4;
+
+namespace disruptor {
+namespace test {
+
+class ValueRequest : public IEventTranslator<int64_t>
+{
+public:
+    explicit ValueRequest(int64_t value) : value_(value) {}
+
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = value_;
+        return event;
+    }
+
+private:
+    const int64_t value_;
+};
+
+// Replies with the negated request, after an optional delay.
+class NegatingServer : public IRequestHandler<int64_t, int64_t>
+{
+public:
+    explicit NegatingServer(int64_t delay_us = 0) : delay_us_(delay_us) {}
+
+    virtual void onRequest(const int64_t& sequence,
+                           int64_t* request,
+                           int64_t* reply)
+    {
+        if (delay_us_ > 0) {
+            boost::this_thread::sleep(
+                    boost::posix_time::microseconds(delay_us_));
+        }
+        *reply = -*request;
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+private:
+    const int64_t delay_us_;
+};
+
+typedef RequestReplyChannel<int64_t, int64_t> Channel;
+
+// Calls with requests of its own, counting the replies not matching them.
+class Client
+{
+public:
+    Client(Channel* channel, int id, int64_t calls)
+        : mismatches_(0)
+        , made_(0)
+        , stopped_(false)
+        , channel_(channel)
+        , id_(id)
+        , calls_(calls)
+        , thread_(boost::bind(&Client::run, this))
+    {
+    }
+
+    void join() { thread_.join(); }
+
+    bool timedJoin(int64_t timeout_ms)
+    {
+        return thread_.timed_join(boost::posix_time::milliseconds(timeout_ms));
+    }
+
+    int64_t                 mismatches_;
+    stdext::atomic<int64_t> made_;
+    stdext::atomic<bool>    stopped_;
+
+private:
+    void run()
+    {
+        try {
+            for (int64_t i = 0; calls_ == 0 || i < calls_; ++i) {
+                const int64_t request = id_ * 1000 * 1000 + i;
+                ValueRequest translator(request);
+                if (channel_->call(&translator) != -request) {
+                    ++mismatches_;
+                }
+                made_.fetch_add(1);
+            }
+        }
+        catch(const std::runtime_error& e) {
+            stopped_.store(true);
+        }
+    }
+
+    Channel*      channel_;
+    const int     id_;
+    const int64_t calls_;
+    boost::thread thread_;
+};
+
+// Sends requests without ever receiving their replies, until the channel
+// stops.
+class TicketFlooder
+{
+public:
+    explicit TicketFlooder(Channel* channel)
+        : sent_(0)
+        , stopped_(false)
+        , channel_(channel)
+        , thread_(boost::bind(&TicketFlooder::run, this))
+    {
+    }
+
+    bool timedJoin(int64_t timeout_ms)
+    {
+        return thread_.timed_join(boost::posix_time::milliseconds(timeout_ms));
+    }
+
+    stdext::atomic<int64_t> sent_;
+    stdext::atomic<bool>    stopped_;
+
+private:
+    void run()
+    {
+        try {
+            ValueRequest translator(7);
+            while (true) {
+                channel_->send(&translator);
+                sent_.fetch_add(1);
+            }
+        }
+        catch(const std::runtime_error& e) {
+            stopped_.store(true);
+        }
+    }
+
+    Channel*      channel_;
+    boost::thread thread_;
+};
+
+class RequestReplyTest : public ::testing::TestWithParam<ReplyWaitOption>
+{
+};
+
+TEST_P(RequestReplyTest, testPairsRepliesWithRequestsOfConcurrentClients)
+{
+    const int64_t calls = REQUEST_RING_SIZE * 20;
+    NegatingServer server;
+    Channel channel(REQUEST_RING_SIZE, kMultiThreadedStrategy,
+                    kYieldingStrategy, GetParam(), &server);
+
+    std::vector< boost::shared_ptr<Client> > clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.push_back(boost::make_shared<Client>(&channel, i + 1, calls));
+    }
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients[i]->join();
+        EXPECT_EQ(calls, clients[i]->made_.load());
+        EXPECT_EQ(0, clients[i]->mismatches_);
+        EXPECT_FALSE(clients[i]->stopped_.load());
+    }
+    channel.stop();
+}
+
+TEST_P(RequestReplyTest, testPairsSlowRepliesWithTheirRequests)
+{
+    // the callers run out of spins and, with kParkForReply, park
+    NegatingServer server(1000);
+    Channel channel(REQUEST_RING_SIZE, kMultiThreadedStrategy,
+                    kBlockingStrategy, GetParam(), &server);
+
+    std::vector< boost::shared_ptr<Client> > clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.push_back(boost::make_shared<Client>(&channel, i + 1, 20));
+    }
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients[i]->join();
+        EXPECT_EQ(20, clients[i]->made_.load());
+        EXPECT_EQ(0, clients[i]->mismatches_);
+    }
+    channel.stop();
+}
+
+TEST_P(RequestReplyTest, testStopReleasesWaitingClients)
+{
+    NegatingServer server(1000);
+    Channel channel(REQUEST_RING_SIZE, kMultiThreadedStrategy,
+                    kBlockingStrategy, GetParam(), &server);
+
+    // calling until the channel stops, most likely while waiting: the
+    // requests already sent are served, the next call throws
+    std::vector< boost::shared_ptr<Client> > clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.push_back(boost::make_shared<Client>(&channel, i + 1, 0));
+    }
+    while (clients[0]->made_.load() < 5) {
+        boost::this_thread::yield();
+    }
+    channel.stop();
+
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        ASSERT_TRUE(clients[i]->timedJoin(1000));
+        EXPECT_TRUE(clients[i]->stopped_.load());
+        EXPECT_EQ(0, clients[i]->mismatches_);
+    }
+}
+
+TEST_P(RequestReplyTest, testStopWithTicketsNeverReceived)
+{
+    NegatingServer server;
+    Channel channel(REQUEST_RING_SIZE, kMultiThreadedStrategy,
+                    kYieldingStrategy, GetParam(), &server);
+
+    // the slots of the flooder's tickets are never released: the dispatcher
+    // gets stuck on the next lap, the reply ring fills up and holds up the
+    // server, and the request ring fills up and holds up the callers
+    TicketFlooder flooder(&channel);
+    std::vector< boost::shared_ptr<Client> > clients;
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        clients.push_back(boost::make_shared<Client>(&channel, i + 1, 0));
+    }
+    while (flooder.sent_.load() < REQUEST_RING_SIZE) {
+        boost::this_thread::yield();
+    }
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    channel.stop();
+
+    ASSERT_TRUE(flooder.timedJoin(1000));
+    EXPECT_TRUE(flooder.stopped_.load());
+    for (int i = 0; i < NUM_CLIENTS; ++i) {
+        ASSERT_TRUE(clients[i]->timedJoin(1000));
+        EXPECT_TRUE(clients[i]->stopped_.load());
+        EXPECT_EQ(0, clients[i]->mismatches_);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(ReplyWaitOptions,
+                        RequestReplyTest,
+                        ::testing::Values(kSpinForReply, kParkForReply));
+
+}
+}
@@ -1,4 +1,5 @@
 #include <exception>
+#include <set>
 #include <vector>
 
 #include <boost/shared_ptr.hpp>
@@ -262,5 +263,24 @@ TEST_F(RingBufferFixture, testPreventPublishersOvertakingEventProcessorWrapPoint
 }
 
 
+TEST(RingBufferTest, testSizeIsRoundedUpToPowerOfTwo)
+{
+    RingBuffer<StubEvent> ring_buffer(1000,
+                                      kSingleThreadedStrategy,
+                                      kSleepingStrategy,
+                                      TimeConfig());
+    EXPECT_EQ(1024, ring_buffer.capacity());
+
+    // every slot of the rounded size is reachable and wraps in place
+    std::set<StubEvent*> slots;
+    for (int64_t sequence = 0; sequence < 1024; ++sequence) {
+        slots.insert(ring_buffer.get(sequence));
+    }
+    EXPECT_EQ(1024U, slots.size());
+    EXPECT_EQ(ring_buffer.get(0), ring_buffer.get(1024));
+    EXPECT_EQ(ring_buffer.get(1000), ring_buffer.get(3048));
+}
+
+
 }; // namespace test
 }; // namespace disruptor
@@ -244,5 +244,25 @@ TEST_F(SequencerFixture, testHoldUpPublisherWhenRingIsFull)
 }
 
 
+TEST(SequencerTest, testCapacityBeyond32Bits)
+{
+    const int64_t size = (1LL << 32) + 1;
+    Sequencer sequencer(size, kSingleThreadedStrategy, kSleepingStrategy);
+    EXPECT_EQ(1LL << 33, sequencer.capacity());
+
+    Sequence gating_sequence(INITIAL_CURSOR_VALUE);
+    std::vector<Sequence*> sequences;
+    sequences.push_back(&gating_sequence);
+    sequencer.setGatingSequences(sequences);
+
+    // claims past 2^31 still see free slots
+    sequencer.forcePublish(sequencer.claim(3000000000LL - 1));
+    EXPECT_TRUE(sequencer.hasAvailableCapacity());
+    EXPECT_EQ(3000000000LL - 1, sequencer.getCursor());
+    EXPECT_EQ(3000000000LL, sequencer.occupiedCapacity());
+    EXPECT_EQ((1LL << 33) - 3000000000LL, sequencer.remainingCapacity());
+}
+
+
 }; // namepspace test
 }; // namepspace disruptor
@@ -0,0 +1,148 @@
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/event_processor.h>
+#include <disruptor/ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+// The event is its own publish time.
+inline int64_t publishTime(const int64_t& event)
+{
+    return event;
+}
+
+class SequenceRecorder : public IEventHandler<int64_t>
+{
+public:
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        sequences_.push_back(sequence);
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    std::vector<int64_t> sequences()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return sequences_;
+    }
+
+private:
+    stdext::mutex        mutex_;
+    std::vector<int64_t> sequences_;
+};
+
+// Publishes a whole backlog before the processor starts, so that it is seen
+// as one batch.
+class StaleEventsFixture : public ::testing::Test
+{
+protected:
+    StaleEventsFixture()
+        : ring_buffer(64, kSingleThreadedStrategy, kBlockingStrategy,
+                      TimeConfig())
+        , processor(&ring_buffer, ring_buffer.newBarrier(DependentSequences()),
+                    &handler, NULL, stdext::chrono::microseconds(0))
+        , now(monotonicNanos())
+    {
+        ring_buffer.setGatingSequences(
+                DependentSequences(1, processor.getSequence()));
+    }
+
+    void publish(bool fresh)
+    {
+        int64_t sequence = ring_buffer.next();
+        // an hour off, whatever the test takes
+        *ring_buffer.get(sequence) =
+            now + (fresh ? 1 : -1) * 3600L * 1000 * 1000 * 1000;
+        ring_buffer.publish(sequence);
+    }
+
+    // @return the sequences handled out of the backlog.
+    std::vector<int64_t> process(bool ordered = true)
+    {
+        processor.setStalenessPolicy(boost::bind(&publishTime, _1),
+                stdext::chrono::microseconds(1000 * 1000), ordered);
+        boost::thread thread(boost::ref(processor));
+        const int64_t last = ring_buffer.getCursor();
+        while (processor.getSequence()->get() < last) {
+            boost::this_thread::yield();
+        }
+        processor.halt();
+        thread.join();
+        return handler.sequences();
+    }
+
+    SequenceRecorder             handler;
+    RingBuffer<int64_t>          ring_buffer;
+    BatchEventProcessor<int64_t> processor;
+    const int64_t                now;
+};
+
+TEST_F(StaleEventsFixture, testSkipsAllStaleBatch)
+{
+    for (int i = 0; i < 10; ++i) {
+        publish(false);
+    }
+    EXPECT_TRUE(process().empty());
+    EXPECT_EQ(10, processor.dropped());
+    EXPECT_EQ(9, processor.getSequence()->get());
+}
+
+TEST_F(StaleEventsFixture, testSkipsStaleStartOfBatch)
+{
+    for (int i = 0; i < 7; ++i) {
+        publish(false);
+    }
+    for (int i = 0; i < 3; ++i) {
+        publish(true);
+    }
+    std::vector<int64_t> handled = process();
+    ASSERT_EQ(3UL, handled.size());
+    EXPECT_EQ(7, handled[0]);
+    EXPECT_EQ(9, handled[2]);
+    EXPECT_EQ(7, processor.dropped());
+}
+
+TEST_F(StaleEventsFixture, testHandlesBatchStartingFresh)
+{
+    publish(true);
+    // only the start of a batch is skipped
+    for (int i = 0; i < 4; ++i) {
+        publish(false);
+    }
+    EXPECT_EQ(5UL, process().size());
+    EXPECT_EQ(0, processor.dropped());
+}
+
+TEST_F(StaleEventsFixture, testUnorderedScanKeepsFreshEvents)
+{
+    // published out of timestamp order, a binary search would land past the
+    // fresh event at 1
+    publish(false);
+    publish(true);
+    for (int i = 0; i < 6; ++i) {
+        publish(false);
+    }
+    publish(true);
+    std::vector<int64_t> handled = process(false);
+    ASSERT_EQ(8UL, handled.size());
+    EXPECT_EQ(1, handled[0]);
+    EXPECT_EQ(1, processor.dropped());
+}
+
+}
+}
@@ -0,0 +1,103 @@
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+#include <disruptor/wait_strategy_tuner.h>
+
+#include <gtest/gtest.h>
+
+namespace disruptor {
+namespace test {
+
+TEST(WaitConfigTest, testTextFormRoundTrips)
+{
+    std::vector<WaitConfig> candidates = defaultWaitCandidates();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        WaitConfig parsed;
+        ASSERT_TRUE(WaitConfig::parse(candidates[i].str(), parsed));
+        EXPECT_EQ(candidates[i].option_, parsed.option_);
+        EXPECT_EQ(candidates[i].sleep_.count(), parsed.sleep_.count());
+    }
+    EXPECT_EQ("precise_sleeping:10", candidates[2].str());
+
+    WaitConfig parsed;
+    EXPECT_FALSE(WaitConfig::parse("spinning", parsed));
+    EXPECT_FALSE(WaitConfig::parse("sleeping:10us", parsed));
+    EXPECT_FALSE(WaitConfig::parse("tunable", parsed));
+}
+
+class NoOpTimedHandler : public IEventHandler<int64_t>
+{
+public:
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+};
+
+class PublishTimeTranslator : public IEventTranslator<int64_t>
+{
+public:
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = monotonicNanos();
+        return event;
+    }
+};
+
+static int64_t publishTime(const int64_t& event)
+{
+    return event;
+}
+
+TEST(WaitStrategyTunerTest, testPicksCheapestWithinTarget)
+{
+    NoOpTimedHandler handler;
+    TunerConfig config;
+    config.objective_ = kLowestCpu;
+    config.latency_target_ = stdext::chrono::microseconds(1000000);
+    // long enough for the 1ms sleeping candidate to wake up well over
+    // min_trial_batches_ times, even with late wake ups
+    config.trial_ = stdext::chrono::microseconds(100 * 1000);
+    config.reevaluate_every_ = stdext::chrono::microseconds(0);
+    config.min_trial_batches_ = 10;
+    WaitStrategyTuner<int64_t> tuner(&handler, &publishTime, config);
+
+    Disruptor<int64_t> disruptor(1024, kSingleThreadedStrategy,
+                                 kTunableStrategy, &tuner, NULL);
+    EXPECT_THROW(WaitStrategyTuner<int64_t>(&handler, &publishTime, config)
+                 .attach(NULL), std::invalid_argument);
+    tuner.attach(disruptor.getWaitStrategy());
+
+    PublishTimeTranslator translator;
+    while (tuner.evaluations() == 0) {
+        disruptor.publishEvent(&translator);
+        boost::this_thread::sleep(boost::posix_time::microseconds(100));
+    }
+    disruptor.stop();
+
+    // any candidate meets a 1s target, the spinning ones cost the most
+    std::vector<TrialResult> results = tuner.results();
+    ASSERT_EQ(defaultWaitCandidates().size(), results.size());
+    double lowest_cpu = 1.0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_GE(results[i].batches_, config.min_trial_batches_);
+        lowest_cpu = std::min(lowest_cpu, results[i].cpu_);
+    }
+    WaitConfig chosen = tuner.chosen();
+    EXPECT_NE(kYieldingStrategy, chosen.option_);
+    EXPECT_NE(kBusySpinStrategy, chosen.option_);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].config_.str() == chosen.str()) {
+            EXPECT_DOUBLE_EQ(lowest_cpu, results[i].cpu_);
+        }
+    }
+}
+
+}
+}
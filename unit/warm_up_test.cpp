@@ -0,0 +1,156 @@
+#include <string>
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/disruptor.h>
+
+#include <gtest/gtest.h>
+
+static const int64_t SYNTHETIC_EVENT = -1;
+static const int64_t WARM_UP_ITERATIONS = 100;
+
+namespace disruptor {
+namespace test {
+
+// Records the life cycle calls, and the sequence of every real event.
+class WarmUpRecorder : public IEventHandler<int64_t>
+{
+public:
+    WarmUpRecorder() : synthetic_(0), leaked_(0), warming_up_(false) {}
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (event == NULL) {
+            return;
+        }
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        if (warming_up_) {
+            synthetic_ += *event == SYNTHETIC_EVENT;
+        }
+        else if (*event == SYNTHETIC_EVENT) {
+            ++leaked_;
+        }
+        else {
+            real_.push_back(sequence);
+        }
+    }
+
+    virtual void onStart() { record("start"); }
+
+    virtual void onShutdown() { record("shutdown"); }
+
+    virtual void onWarmUp(const bool& warming_up)
+    {
+        record(warming_up ? "warm_up" : "live");
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        warming_up_ = warming_up;
+    }
+
+    void waitForReal(size_t count)
+    {
+        while (real().size() < count) {
+            boost::this_thread::yield();
+        }
+    }
+
+    std::vector<int64_t> real()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return real_;
+    }
+
+    // The life cycle calls so far, separated by spaces.
+    std::string calls()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return calls_;
+    }
+
+    int64_t synthetic_;
+    int64_t leaked_;
+
+private:
+    void record(const char* call)
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        calls_ += calls_.empty() ? call : std::string(" ") + call;
+    }
+
+    stdext::mutex        mutex_;
+    bool                 warming_up_;
+    std::vector<int64_t> real_;
+    std::string          calls_;
+};
+
+class ConstantTranslator : public IEventTranslator<int64_t>
+{
+public:
+    explicit ConstantTranslator(int64_t value) : value_(value) {}
+
+    virtual int64_t* translateTo(const int64_t& sequence, int64_t* event)
+    {
+        *event = value_;
+        return event;
+    }
+
+private:
+    const int64_t value_;
+};
+
+TEST(WarmUpTest, testFirstEventAfterWarmUpIsPublishedAtZero)
+{
+    WarmUpRecorder handler;
+    ConstantTranslator synthetic(SYNTHETIC_EVENT);
+    ConstantTranslator real(42);
+    Disruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                 kBlockingStrategy, &handler, NULL);
+
+    // more synthetic events than the ring holds, so that it wraps
+    EXPECT_TRUE(disruptor.warmUp(&synthetic, WARM_UP_ITERATIONS));
+    EXPECT_EQ(INITIAL_CURSOR_VALUE, disruptor.processor().getSequence()->get());
+
+    disruptor.publishEvent(&real);
+    handler.waitForReal(1);
+    disruptor.stop();
+
+    std::vector<int64_t> sequences = handler.real();
+    ASSERT_EQ(1UL, sequences.size());
+    EXPECT_EQ(0, sequences[0]);
+    EXPECT_EQ(WARM_UP_ITERATIONS, handler.synthetic_);
+    EXPECT_EQ(0, handler.leaked_);
+    EXPECT_EQ("start shutdown warm_up start shutdown live start shutdown",
+              handler.calls());
+}
+
+TEST(WarmUpTest, testDynamicFirstEventAfterWarmUpIsSeenOnce)
+{
+    WarmUpRecorder handler;
+    TimeConfig time_config;
+    time_config[kMaxIdle] = stdext::chrono::microseconds(1000);
+    DynamicDisruptor<int64_t> disruptor(64, kSingleThreadedStrategy,
+                                        kSleepingStrategy, &handler, NULL,
+                                        time_config);
+
+    EXPECT_TRUE(disruptor.warmUp(SYNTHETIC_EVENT, WARM_UP_ITERATIONS, 256));
+    EXPECT_EQ(INITIAL_CURSOR_VALUE, disruptor.processor().getSequence()->get());
+
+    disruptor.publishEvent(42);
+    handler.waitForReal(1);
+    disruptor.stop();
+
+    std::vector<int64_t> sequences = handler.real();
+    ASSERT_EQ(1UL, sequences.size());
+    EXPECT_EQ(0, sequences[0]);
+    EXPECT_EQ(0, disruptor.processor().getSequence()->get());
+    EXPECT_EQ(WARM_UP_ITERATIONS, handler.synthetic_);
+    EXPECT_EQ(0, handler.leaked_);
+    EXPECT_EQ("start shutdown warm_up start shutdown live start shutdown",
+              handler.calls());
+}
+
+}
+}
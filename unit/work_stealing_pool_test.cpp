@@ -0,0 +1,195 @@
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <disruptor/work_stealing_pool.h>
+
+#include <gtest/gtest.h>
+
+static const int STEALING_BUFFER_SIZE = 64;
+
+namespace disruptor {
+namespace test {
+
+// Checks the events of one ring are handled in order, once, and never by two
+// threads at the same time.
+class OrderCheckingHandler : public IEventHandler<int64_t>
+{
+public:
+    OrderCheckingHandler(int64_t delay_us = 0)
+        : handled_(0)
+        , in_flight_(0)
+        , overlaps_(0)
+        , out_of_order_(0)
+        , last_(INITIAL_CURSOR_VALUE)
+        , started_(0)
+        , shutdowns_(0)
+        , delay_us_(delay_us)
+    {
+    }
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (in_flight_.fetch_add(1) != 0) {
+            overlaps_.fetch_add(1);
+        }
+        if (delay_us_ > 0) {
+            boost::this_thread::sleep(
+                    boost::posix_time::microseconds(delay_us_));
+        }
+        if (*event != last_ + 1) {
+            out_of_order_.fetch_add(1);
+        }
+        last_ = *event;
+        in_flight_.fetch_sub(1);
+        handled_.fetch_add(1);
+    }
+
+    virtual void onStart() { started_.fetch_add(1); }
+
+    virtual void onShutdown() { shutdowns_.fetch_add(1); }
+
+    stdext::atomic<int64_t> handled_;
+    stdext::atomic<int>     in_flight_;
+    stdext::atomic<int64_t> overlaps_;
+    stdext::atomic<int64_t> out_of_order_;
+    int64_t                 last_;
+    stdext::atomic<int>     started_;
+    stdext::atomic<int>     shutdowns_;
+
+private:
+    const int64_t delay_us_;
+};
+
+struct StealableRing
+{
+    StealableRing(int64_t delay_us = 0)
+        : ring_buffer(STEALING_BUFFER_SIZE, kSingleThreadedStrategy,
+                      kBusySpinStrategy, TimeConfig())
+        , handler(delay_us)
+        , processor(&ring_buffer,
+                    ring_buffer.newBarrier(DependentSequences()),
+                    &handler,
+                    NULL)
+    {
+        ring_buffer.setGatingSequences(
+                DependentSequences(1, processor.getSequence()));
+    }
+
+    void publish(int64_t count)
+    {
+        for (int64_t i = 0; i < count; ++i) {
+            int64_t sequence = ring_buffer.next();
+            *ring_buffer.get(sequence) = sequence;
+            ring_buffer.publish(sequence);
+        }
+    }
+
+    RingBuffer<int64_t>                ring_buffer;
+    OrderCheckingHandler               handler;
+    CooperativeEventProcessor<int64_t> processor;
+};
+
+typedef std::vector< boost::shared_ptr<StealableRing> > StealableRings;
+
+static void waitForAll(const StealableRings& rings, int64_t handled)
+{
+    for (size_t i = 0; i < rings.size(); ++i) {
+        while (rings[i]->handler.handled_.load() < handled) {
+            boost::this_thread::yield();
+        }
+    }
+}
+
+TEST(WorkStealingPoolTest, testStealsFromBusyWorker)
+{
+    const int64_t events = 20;
+    StealableRings rings;
+    WorkStealingPool pool(2, 1);
+    // thread 0 owns both rings and is held up by the slow one
+    for (int i = 0; i < 2; ++i) {
+        rings.push_back(boost::make_shared<StealableRing>(1000));
+        pool.add(&rings.back()->processor, 0);
+    }
+    pool.start();
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        rings[i]->publish(events);
+    }
+    waitForAll(rings, events);
+    pool.stop();
+
+    EXPECT_LT(0, pool.stolen(1));
+    EXPECT_EQ(0, pool.stolen(0));
+    for (size_t i = 0; i < rings.size(); ++i) {
+        EXPECT_EQ(events, rings[i]->handler.handled_.load());
+        EXPECT_EQ(0, rings[i]->handler.overlaps_.load());
+        EXPECT_EQ(0, rings[i]->handler.out_of_order_.load());
+    }
+}
+
+TEST(WorkStealingPoolTest, testHandlesEveryEventOnceAcrossOwnersAndThieves)
+{
+    const int64_t events = STEALING_BUFFER_SIZE * 50;
+    StealableRings rings;
+    // threads 2 and 3 own nothing and live off stealing
+    WorkStealingPool pool(4, 8);
+    for (int i = 0; i < 8; ++i) {
+        rings.push_back(boost::make_shared<StealableRing>());
+        pool.add(&rings.back()->processor, i % 2);
+    }
+    pool.start();
+
+    for (int64_t j = 0; j < events; ++j) {
+        for (size_t i = 0; i < rings.size(); ++i) {
+            rings[i]->publish(1);
+        }
+    }
+    waitForAll(rings, events);
+    pool.stop();
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        const OrderCheckingHandler& handler = rings[i]->handler;
+        EXPECT_EQ(events, handler.handled_.load());
+        EXPECT_EQ(events - 1, handler.last_);
+        EXPECT_EQ(0, handler.overlaps_.load());
+        EXPECT_EQ(0, handler.out_of_order_.load());
+        EXPECT_EQ(1, handler.started_.load());
+    }
+}
+
+TEST(WorkStealingPoolTest, testStopShutsDownStartedRings)
+{
+    StealableRings rings;
+    WorkStealingPool pool(2);
+    for (int i = 0; i < 3; ++i) {
+        rings.push_back(boost::make_shared<StealableRing>());
+        pool.add(&rings.back()->processor, i);
+    }
+    pool.start();
+    EXPECT_THROW(pool.start(), std::runtime_error);
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        rings[i]->publish(10);
+    }
+    waitForAll(rings, 10);
+    pool.stop();
+    pool.stop();
+
+    for (size_t i = 0; i < rings.size(); ++i) {
+        EXPECT_EQ(1, rings[i]->handler.started_.load());
+        EXPECT_EQ(1, rings[i]->handler.shutdowns_.load());
+    }
+
+    // nothing is consumed once stopped
+    rings[0]->publish(1);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    EXPECT_EQ(10, rings[0]->handler.handled_.load());
+}
+
+}
+}
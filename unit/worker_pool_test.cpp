@@ -0,0 +1,240 @@
+#include <vector>
+
+#include <boost/thread.hpp>
+
+#include <disruptor/worker_pool.h>
+
+#include <gtest/gtest.h>
+
+#include "time.h"
+
+namespace disruptor {
+namespace test {
+
+// Counts how many times each sequence is handled, and checks the event was
+// not overwritten before.
+class TallyHandler : public IEventHandler<int64_t>
+{
+public:
+    TallyHandler(int64_t events, int64_t delay_us = 0)
+        : tally_(events, 0)
+        , handled_(0)
+        , overwritten_(0)
+        , delay_us_(delay_us)
+    {
+    }
+
+    virtual void onEvent(const int64_t& sequence,
+                         const int64_t& batch_size,
+                         const bool& end_of_batch,
+                         int64_t* event)
+    {
+        if (delay_us_ > 0) {
+            boost::this_thread::sleep(boost::posix_time::microseconds(delay_us_));
+        }
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        if (*event != sequence) {
+            ++overwritten_;
+        }
+        if (sequence < (int64_t)tally_.size()) {
+            ++tally_[sequence];
+        }
+        handled_.fetch_add(1);
+    }
+
+    virtual void onStart() {}
+
+    virtual void onShutdown() {}
+
+    void waitFor(const int64_t& handled)
+    {
+        while (handled_.load() < handled) {
+            boost::this_thread::yield();
+        }
+    }
+
+    // Number of sequences not handled exactly once.
+    int64_t misses()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        int64_t misses = 0;
+        for (size_t i = 0; i < tally_.size(); ++i) {
+            misses += tally_[i] != 1;
+        }
+        return misses;
+    }
+
+    int64_t overwritten()
+    {
+        stdext::unique_lock<stdext::mutex> ulock(mutex_);
+        return overwritten_;
+    }
+
+    stdext::atomic<int64_t> handled_;
+
+private:
+    stdext::mutex        mutex_;
+    std::vector<int>     tally_;
+    int64_t              overwritten_;
+    const int64_t        delay_us_;
+};
+
+class WorkerPoolFixture : public ::testing::Test
+{
+protected:
+    WorkerPoolFixture()
+        : ring_buffer(8, kSingleThreadedStrategy, kBlockingStrategy,
+                      TimeConfig())
+        , published(INITIAL_CURSOR_VALUE)
+    {
+    }
+
+    ~WorkerPoolFixture()
+    {
+        if (publisher.joinable()) {
+            publisher.join();
+        }
+    }
+
+    void publish(int64_t count)
+    {
+        for (int64_t i = 0; i < count; ++i) {
+            int64_t sequence = ring_buffer.next();
+            *ring_buffer.get(sequence) = sequence;
+            ring_buffer.publish(sequence);
+            published.store(sequence);
+        }
+    }
+
+    void publishInBackground(int64_t count)
+    {
+        boost::thread thread(boost::bind(&WorkerPoolFixture::publish, this,
+                                         count));
+        publisher.swap(thread);
+    }
+
+    static void settle()
+    {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(20));
+    }
+
+    RingBuffer<int64_t>     ring_buffer;
+    stdext::atomic<int64_t> published;
+    boost::thread           publisher;
+};
+
+TEST_F(WorkerPoolFixture, testPublishersGatedBeforeStart)
+{
+    TallyHandler handler(20);
+    ElasticWorkerPool<int64_t> pool(&ring_buffer,
+            ring_buffer.newBarrier(DependentSequences()), &handler, NULL,
+            ElasticityConfig(2, 2, 1000, 0), stdext::chrono::microseconds(1000));
+    ring_buffer.setGatingSequences(pool.getWorkerSequences());
+
+    // the ring holds 8 events, nobody consumes them yet
+    publishInBackground(20);
+    settle();
+    EXPECT_EQ(7, published.load());
+
+    pool.start();
+    handler.waitFor(20);
+    pool.halt();
+    EXPECT_EQ(0, handler.misses());
+    EXPECT_EQ(0, handler.overwritten());
+}
+
+TEST_F(WorkerPoolFixture, testHaltAndRestart)
+{
+    TallyHandler handler(30);
+    ElasticWorkerPool<int64_t> pool(&ring_buffer,
+            ring_buffer.newBarrier(DependentSequences()), &handler, NULL,
+            ElasticityConfig(2, 2, 1000, 0), stdext::chrono::microseconds(1000));
+    ring_buffer.setGatingSequences(pool.getWorkerSequences());
+
+    pool.start();
+    publish(10);
+    handler.waitFor(10);
+    pool.halt();
+    EXPECT_EQ(0, pool.activeWorkers());
+
+    // publishers wrap up to the last event handled, not past it
+    publishInBackground(20);
+    settle();
+    EXPECT_EQ(17, published.load());
+
+    pool.start();
+    handler.waitFor(30);
+    pool.halt();
+    EXPECT_EQ(0, handler.misses());
+    EXPECT_EQ(0, handler.overwritten());
+}
+
+TEST_F(WorkerPoolFixture, testHaltDoesNotWaitForEvents)
+{
+    TallyHandler handler(0);
+    ElasticWorkerPool<int64_t> pool(&ring_buffer,
+            ring_buffer.newBarrier(DependentSequences()), &handler, NULL,
+            ElasticityConfig(3, 3, 1000, 0),
+            stdext::chrono::microseconds(60 * 1000 * 1000));
+    ring_buffer.setGatingSequences(pool.getWorkerSequences());
+
+    pool.start();
+    settle();
+    const MonoTime start = MonoClock::now();
+    pool.halt();
+    EXPECT_GT(Seconds(1), MonoClock::now() - start);
+}
+
+TEST_F(WorkerPoolFixture, testWorkersWakeDependentStage)
+{
+    TallyHandler handler(5);
+    ElasticWorkerPool<int64_t> pool(&ring_buffer,
+            ring_buffer.newBarrier(DependentSequences()), &handler, NULL,
+            ElasticityConfig(2, 2, 1000, 0), stdext::chrono::microseconds(1000));
+    ring_buffer.setGatingSequences(pool.getWorkerSequences());
+    SequenceBarrierPtr downstream =
+        ring_buffer.newBarrier(pool.getWorkerSequences());
+
+    pool.start();
+    publish(5);
+    // without a signal from the workers, only the timeout ends the wait
+    const int64_t start = monotonicNanos();
+    EXPECT_LE(4, downstream->waitFor(4,
+                stdext::chrono::microseconds(10 * 1000 * 1000)));
+    EXPECT_GT(1000L * 1000 * 1000, monotonicNanos() - start);
+    pool.halt();
+}
+
+TEST_F(WorkerPoolFixture, testGrowsWithLagAndShrinksBack)
+{
+    const int64_t events = 200;
+    TallyHandler handler(events, 500);
+    ElasticityConfig config(1, 4, 2, 1);
+    config.hysteresis = 2;
+    config.sample_interval = stdext::chrono::microseconds(500);
+    ElasticWorkerPool<int64_t> pool(&ring_buffer,
+            ring_buffer.newBarrier(DependentSequences()), &handler, NULL,
+            config, stdext::chrono::microseconds(1000));
+    ring_buffer.setGatingSequences(pool.getWorkerSequences());
+
+    pool.start();
+    EXPECT_EQ(1, pool.activeWorkers());
+    publishInBackground(events);
+
+    int max_workers = 0;
+    while (handler.handled_.load() < events) {
+        max_workers = std::max(max_workers, pool.activeWorkers());
+        boost::this_thread::sleep(boost::posix_time::microseconds(200));
+    }
+    EXPECT_LT(1, max_workers);
+
+    while (pool.activeWorkers() > 1) {
+        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+    }
+    pool.halt();
+    EXPECT_EQ(0, handler.misses());
+    EXPECT_EQ(0, handler.overwritten());
+}
+
+}
+}